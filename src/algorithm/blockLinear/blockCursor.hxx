@@ -0,0 +1,92 @@
+#ifndef ALGORITHM_BLOCK_LINEAR_BLOCK_CURSOR__HXX
+#define ALGORITHM_BLOCK_LINEAR_BLOCK_CURSOR__HXX
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "mappingOffset.hxx"
+
+namespace pcat::algorithm::blockLinear
+{
+	/*!
+	 * A block cursor lets workers plan their own work. It covers a set of ranges of the
+	 * output, laid end to end, and each worker claims the next block by bumping a shared
+	 * atomic position along by the block size. That block is then mapped back to its
+	 * place in the inputs. This replaces having a single thread walk the whole output
+	 * and queue each block in turn. As each claim reads the block size afresh, blocks
+	 * follow the block size as --block-size=auto tunes it, and are cut to stripe boundaries in
+	 * the output when its stripe layout is known.
+	 *
+	 * Blocks never cross from one range to the next, so a cursor given only the ranges
+	 * of one device's inputs only ever hands out blocks that come from that device.
+	 */
+	struct blockCursor_t final
+	{
+	private:
+		std::vector<mappingOffset_t> ranges{};
+		// rangeStarts[n] is where range n begins with the ranges laid end to end,
+		// with the extra last entry being the total length of them all
+		std::vector<off_t> rangeStarts{0};
+		std::atomic<off_t> position{0};
+
+	public:
+		blockCursor_t() = default;
+		blockCursor_t(const blockCursor_t &) = delete;
+		blockCursor_t(blockCursor_t &&) = delete;
+		~blockCursor_t() noexcept = default;
+		blockCursor_t &operator =(const blockCursor_t &) = delete;
+		blockCursor_t &operator =(blockCursor_t &&) = delete;
+
+		// Adds a range of the output to the cursor, merging it with the last if they are contiguous
+		void addRange(const off_t offset, const off_t length)
+		{
+			if (!length)
+				return;
+			if (!ranges.empty() && ranges.back().offset() + ranges.back().length() == offset)
+			{
+				auto &range{ranges.back()};
+				range.length(range.length() + length);
+				rangeStarts.back() += length;
+			}
+			else
+			{
+				ranges.emplace_back(offset, length);
+				rangeStarts.emplace_back(rangeStarts.back() + length);
+			}
+		}
+
+		// How many blocks the cursor covers at the block size as it currently stands
+		[[nodiscard]] std::size_t blocks() const noexcept
+		{
+			const auto size{blockSize.current()};
+			std::size_t blocks{};
+			for (const auto &range : ranges)
+				blocks += std::size_t((range.length() + size - 1) / size);
+			return blocks;
+		}
+
+		[[nodiscard]] auto empty() const noexcept { return ranges.empty(); }
+
+		// Claims the next block of the output, which has zero length once there are none left
+		[[nodiscard]] mappingOffset_t next() noexcept
+		{
+			auto begin{position.load(std::memory_order_relaxed)};
+			std::size_t index{};
+			off_t end{};
+			do
+			{
+				if (begin >= rangeStarts.back())
+					return {};
+				// The first range to start after this block is the one after the range holding it
+				const auto next{std::upper_bound(rangeStarts.begin() + 1, rangeStarts.end(), begin)};
+				index = std::size_t(next - rangeStarts.begin()) - 1U;
+				end = begin + blockLength(ranges[index].offset() + (begin - rangeStarts[index]), *next - begin);
+			}
+			while (!position.compare_exchange_weak(begin, end, std::memory_order_relaxed));
+			return {ranges[index].offset() + (begin - rangeStarts[index]), end - begin};
+		}
+	};
+} // namespace pcat::algorithm::blockLinear
+
+#endif /*ALGORITHM_BLOCK_LINEAR_BLOCK_CURSOR__HXX*/
@@ -2,6 +2,7 @@
 #define ALGORITHM_BLOCK_LINEAR_CHUNK_STATE__HXX
 
 #include <cassert>
+#include <algorithm>
 #include "mappingOffset.hxx"
 
 namespace pcat::algorithm::blockLinear
@@ -21,7 +22,7 @@ namespace pcat::algorithm::blockLinear
 			{
 				assert(file_ != inputFiles.end()); // NOLINT
 				++file_;
-				inputLength_ = file_ == inputFiles.end() ? 0 : file_->length();
+				inputLength_ = inputFiles.lengthOf(file_);
 				inputOffset_ = {};
 			}
 			inputOffset_.length(std::min(remainder, inputLength_));
@@ -43,12 +44,15 @@ namespace pcat::algorithm::blockLinear
 		[[nodiscard]] constexpr const mappingOffset_t &inputOffset() const noexcept { return inputOffset_; }
 		[[nodiscard]] constexpr const mappingOffset_t &outputOffset() const noexcept { return outputOffset_; }
 
+		// Jumps straight to where the chunk ends in the inputs rather than stepping through each sub-chunk
 		[[nodiscard]] chunkState_t end() const noexcept
 		{
-			chunkState_t state{*this};
-			while (!state.atEnd())
-				++state;
-			return state;
+			if (atEnd())
+				return *this;
+			const auto [file, offset] = inputFiles.locate(inputFiles.offsetOf(file_) + inputOffset_.offset() +
+				outputOffset_.length());
+			return {file, inputFiles.lengthOf(file), {offset, 0},
+				{outputOffset_.offset() + outputOffset_.length(), 0}};
 		}
 
 		[[nodiscard]] constexpr bool atEnd() const noexcept
@@ -73,6 +77,14 @@ namespace pcat::algorithm::blockLinear
 		}
 		bool operator !=(const chunkState_t &other) const noexcept { return !(*this == other); }
 	};
+
+	// Finds which input, and where in it, the start of an output block lands
+	inline chunkState_t locateBlock(const mappingOffset_t &block) noexcept
+	{
+		const auto [file, offset] = inputFiles.locate(block.offset());
+		const auto inputLength{inputFiles.lengthOf(file)};
+		return {file, inputLength, {offset, std::min(block.length(), inputLength - offset)}, block};
+	}
 } // namespace pcat::algorithm::blockLinear
 
 #endif /*ALGORITHM_BLOCK_LINEAR_CHUNK_STATE__HXX*/
@@ -1,29 +1,164 @@
 #include <string_view>
+#include <vector>
+#include <atomic>
+#include <algorithm>
 #include <substrate/console>
+#include <substrate/utility>
 #include "copyChunk.hxx"
-#include "threadPool.hxx"
-#include "algorithm/blockLinear/fileChunker.hxx"
+#include "threadGroups.hxx"
+#include "residency.hxx"
+#include "physicalOrder.hxx"
+#include "numaTopology.hxx"
+#include "algorithm/blockLinear/chunkState.hxx"
+#include "algorithm/blockLinear/blockCursor.hxx"
 
 using namespace std::literals::string_view_literals;
 using substrate::console;
 
 namespace pcat::algorithm::blockLinear
 {
+	int32_t copyBlocks(blockCursor_t *const cursors, const numaTopology_t *const topology,
+		std::atomic<bool> *const aborted)
+	{
+		// Work through this node's slice of the output first, then help the other nodes finish theirs
+		const auto nodes{topology->nodes()};
+		const auto localNode{topology->currentNode()};
+		for (std::size_t node{}; node < nodes; ++node)
+		{
+			auto &cursor{cursors[(localNode + node) % nodes]};
+			for (auto block{cursor.next()}; block.length() && !*aborted;)
+			{
+				// A block only has a next sub-chunk for copyChunk() to prefetch where it crosses into another
+				// input, so claim our next block now and get its start in flight while this one is copied
+				const auto nextBlock{cursor.next()};
+				if (nextBlock.length() && !inputFiles.lazy())
+				{
+					const auto chunk{locateBlock(nextBlock)};
+					prefetchInput(chunk.inputFile(), chunk.inputOffset());
+				}
+				if (const auto result{copyChunk(locateBlock(block))}; result)
+				{
+					*aborted = true;
+					return result;
+				}
+				throughput::pace();
+				block = nextBlock;
+			}
+		}
+		return 0;
+	}
+
+	// A range of the output that comes from a single input, and where it starts on that input's device
+	struct inputRange_t final
+	{
+		std::size_t file;
+		off_t offset;
+		off_t length;
+		uint64_t physical;
+	};
+
+	/*!
+	 * Plans the order the output is copied in, as one range per input in the order of the
+	 * output. With --physical-order, each input is split up into its extents instead, and
+	 * those are put in the order they lie on their devices. With --cached-first, the ranges
+	 * already in the page cache are then moved to the front.
+	 */
+	[[nodiscard]] std::vector<inputRange_t> planRanges()
+	{
+		const auto physical{::args->find(argType_t::physicalOrder) && !inputFiles.lazy()};
+		std::vector<inputRange_t> plan{};
+		plan.reserve(inputFiles.size());
+		for (std::size_t file{}; file < inputFiles.size(); ++file)
+		{
+			const auto offset{inputFiles.offsetOf(file)};
+			const auto length{inputFiles.lengthOf(file)};
+			const auto extents{physical ? readExtents(inputFiles[file], 0, length) : std::vector<physicalExtent_t>{}};
+			if (extents.empty())
+				plan.push_back({file, offset, length, 0U});
+			for (const auto &extent : extents)
+				plan.push_back({file, offset + extent.offset, extent.length, extent.physical});
+		}
+		if (physical)
+			physicalOrder(plan, [](const inputRange_t &range) noexcept
+				{ return std::make_pair(inputFiles.deviceOf(range.file), range.physical); });
+		if (::args->find(argType_t::cachedFirst))
+			cachedFirst(plan, [](const inputRange_t &range) noexcept
+				{ return std::make_pair(range.offset, range.length); });
+		return plan;
+	}
+
+	/*!
+	 * Splits each device group's part of the output into one contiguous slice per NUMA node,
+	 * each with its own cursor. Workers start on their own node's slice, so the output pages
+	 * they fault in are first touched, and so allocated, on memory local to them. Ranges are
+	 * placed in the order of the plan, which is the order each cursor hands them out in.
+	 */
+	void placeBlocks(blockCursor_t *const cursors, const std::vector<inputRange_t> &plan, const std::size_t groups,
+		const std::size_t nodes)
+	{
+		std::vector<off_t> groupLength(groups);
+		for (const auto &range : plan)
+			groupLength[deviceGroups.groupOf(range.file)] += range.length;
+		std::vector<off_t> groupPlaced(groups);
+		for (const auto &range : plan)
+		{
+			const auto group{deviceGroups.groupOf(range.file)};
+			const auto size{blockSize.current()};
+			const auto blocks{(groupLength[group] + size - 1) / size};
+			const auto sliceLength{std::max<off_t>((blocks + off_t(nodes) - 1) / off_t(nodes), 1) * size};
+			auto offset{range.offset};
+			auto length{range.length};
+			while (length)
+			{
+				auto &placed{groupPlaced[group]};
+				const auto node{std::min(std::size_t(placed / sliceLength), nodes - 1U)};
+				const auto amount
+				{
+					node == nodes - 1U ? length : std::min(length, (off_t(node + 1U) * sliceLength) - placed)
+				};
+				cursors[(group * nodes) + node].addRange(offset, amount);
+				offset += amount;
+				length -= amount;
+				placed += amount;
+			}
+		}
+	}
+
 	int32_t chunkedCopy() noexcept try
 	{
-		threadPool_t copyThreads{copyChunk<chunkState_t>};
-		fileChunker_t chunker{};
-		assert(copyThreads.ready());
+		// Give each device group a cursor per NUMA node over just the parts of the output its inputs make up
+		const numaTopology_t topology{};
+		const auto nodes{topology.nodes()};
+		const auto groups{std::max<std::size_t>(deviceGroups.size(), 1U)};
+		// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+		const auto cursors{substrate::make_unique<blockCursor_t []>(groups * nodes)};
+		placeBlocks(cursors.get(), planRanges(), groups, nodes);
+		std::atomic<bool> aborted{false};
+		// The slow path has to outlive the copy workers as they feed it
+		slowPath_t slowPath{};
+		threadGroups_t copyThreads{copyBlocks};
 
-		for (const chunkState_t &chunk : chunker)
+		for (std::size_t group{}; group < copyThreads.groups(); ++group)
 		{
-			if (const auto result{copyThreads.queue(chunk)}; result)
+			// Workers plan their own blocks from the cursors, so each just needs starting once
+			std::size_t blocks{};
+			for (std::size_t node{}; node < nodes; ++node)
+				blocks += cursors[(group * nodes) + node].blocks();
+			const auto workers{std::min(copyThreads.workers(group), blocks)};
+			for (std::size_t worker{}; worker < workers; ++worker)
 			{
-				console.error("Copying failed: "sv, std::strerror(result));
-				return result;
+				if (const auto result{copyThreads.queue(group, cursors.get() + (group * nodes), &topology, &aborted)};
+					result)
+				{
+					console.error("Copying failed: "sv, std::strerror(result));
+					aborted = true;
+					return result;
+				}
 			}
 		}
-		return copyThreads.finish();
+		const auto result{copyThreads.finish()};
+		const auto slowResult{slowPath.finish()};
+		return result ? result : slowResult;
 	}
 	catch (std::system_error &error)
 	{
@@ -9,26 +9,26 @@ namespace pcat::algorithm::blockLinear
 	{
 	private:
 		inputFilesIterator_t file{inputFiles.begin()};
-		off_t inputLength{file == inputFiles.end() ? 0 : file->length()};
+		off_t inputLength{inputFiles.lengthOf(file)};
 		mappingOffset_t inputOffset{0, blockLength(inputLength)};
 		const off_t outputLength{outputFile.length()};
 		mappingOffset_t outputOffset{};
 
-		constexpr void nextInputBlock() noexcept
+		// Finds where in the inputs the current output block begins
+		void seekInput() noexcept
 		{
-			inputOffset += inputOffset.length();
-			if (inputOffset.offset() == inputLength)
-			{
-				assert(file != inputFiles.end()); // NOLINT
-				++file;
-				inputLength = file == inputFiles.end() ? 0 : file->length();
-				inputOffset = {};
-			}
-			inputOffset.length(blockLength(inputLength - inputOffset));
-		};
+			const auto [nextFile, offset] = inputFiles.locate(outputOffset);
+			file = nextFile;
+			inputLength = inputFiles.lengthOf(file);
+			inputOffset = {offset, std::min(outputOffset.length(), inputLength - offset)};
+		}
 
 	public:
-		chunking_t() noexcept { outputOffset.length(blockLength(outputLength - outputOffset)); }
+		chunking_t() noexcept
+		{
+			outputOffset.length(blockLength(0, outputLength));
+			inputOffset.length(std::min(outputOffset.length(), inputLength));
+		}
 		chunking_t(const inputFilesIterator_t file_) noexcept : file{file_}, outputOffset{outputLength} { }
 		[[nodiscard]] chunkState_t subchunkState() const noexcept
 			{ return {file, inputLength, inputOffset, outputOffset}; }
@@ -38,16 +38,9 @@ namespace pcat::algorithm::blockLinear
 		{
 			if (outputOffset == outputLength)
 				return;
-			else if (outputOffset.length() != inputOffset.length())
-			{
-				const auto state{subchunkState().end()};
-				file = state.file();
-				inputLength = state.inputLength();
-				inputOffset = state.inputOffset();
-			}
-			nextInputBlock();
 			outputOffset += outputOffset.length();
-			outputOffset.length(blockLength(outputLength - outputOffset));
+			outputOffset.length(blockLength(outputOffset.offset(), outputLength - outputOffset));
+			seekInput();
 		}
 
 		bool operator ==(const chunking_t &other) const noexcept
@@ -1,8 +1,13 @@
 #include <string_view>
+#include <vector>
 #include <substrate/console>
 #include "copyChunk.hxx"
 #include "threadPool.hxx"
+#include "threadGroups.hxx"
+#include "residency.hxx"
+#include "physicalOrder.hxx"
 #include "algorithm/chunkSpans/fileChunker.hxx"
+#include "algorithm/chunkSpans/guidedScheduler.hxx"
 
 using namespace std::literals::string_view_literals;
 using substrate::console;
@@ -12,8 +17,8 @@ namespace pcat::algorithm::chunkSpans
 	/*!
 	 * The idea with this is that, we take the total length of the file,
 	 * the number of threads and divide them together if there are more than
-	 * (transferBlockSize * threads) bytes to move, otherwise splitting
-	 * the blocks up into transferBlockSize chunks.
+	 * (block size * threads) bytes to move, otherwise splitting
+	 * the blocks up into block size chunks.
 	 *
 	 * The result should be up to threads chunks which are then scheduled
 	 * off one onto each thread, and copied linearly within that thread.
@@ -25,30 +30,133 @@ namespace pcat::algorithm::chunkSpans
 	template<typename int_t> constexpr inline std::make_unsigned_t<int_t>
 		asUnsigned(int_t value) noexcept { return value; }
 
-	int32_t chunkedCopy() noexcept try
+	int32_t copyGuided(guidedScheduler_t *const scheduler, const std::size_t worker)
 	{
-		const auto length{asUnsigned(outputFile.length())};
-		threadPool_t copyThreads{copyChunk<chunkState_t>};
-		assert(copyThreads.ready());
+		while (scheduler->nextPiece(worker))
+		{
+			auto block{scheduler->nextBlock(worker)};
+			auto chunk{locateBlock(block)};
+			while (block.length())
+			{
+				if (const auto result{copyChunk(chunk)}; result)
+				{
+					scheduler->abort();
+					return result;
+				}
+				throughput::pace();
+				// Blocks within a piece are contiguous, so pick up in the inputs where the last one left off
+				const auto state{chunk.end()};
+				const auto inputOffset{state.inputOffset().offset()};
+				block = scheduler->nextBlock(worker);
+				chunk = {state.file(), state.inputLength(), {inputOffset,
+					blockLength(block.offset(), std::min(block.length(), state.inputLength() - inputOffset))}, block};
+			}
+		}
+		return 0;
+	}
+
+	int32_t guidedCopy()
+	{
+		// The scheduler must outlive the pool as the workers hold a pointer to it
+		guidedScheduler_t scheduler{outputFile.length(), affinity_t{}.numProcessors()};
+		threadPool_t copyThreads{copyGuided, scheduler.workers()};
+		if (throughput::automatic())
+			copyThreads.controlThroughput();
 
-		if ((transferBlockSize * copyThreads.numProcessors()) >= length)
+		for (std::size_t worker{}; worker < scheduler.workers(); ++worker)
 		{
-			console.info("Using the short file form of the algorithm"sv);
-			return 0;
+			if (const auto result{copyThreads.queue(&scheduler, worker)}; result)
+			{
+				console.error("Copying failed: "sv, std::strerror(result));
+				scheduler.abort();
+				return result;
+			}
 		}
+		return copyThreads.finish();
+	}
 
-		const auto chunksPerSpan{outputFile.length() / (transferBlockSize * copyThreads.numProcessors())};
-		fileChunker_t chunker{std::size_t(chunksPerSpan * transferBlockSize)};
+	/*!
+	 * Spans run across inputs and so across devices, so to queue each span on the pool for the device
+	 * it copies from, they're cut where the inputs they cover change device group. Each piece keeps
+	 * to one group and is copied linearly on its own, just as a whole span would be.
+	 */
+	std::vector<chunkState_t> cutAtGroups(const std::vector<chunkState_t> &spans)
+	{
+		if (deviceGroups.size() < 2U)
+			return spans;
+		std::vector<chunkState_t> pieces{};
+		pieces.reserve(spans.size());
+		for (const auto &span : spans)
+		{
+			const auto end{span.outputOffset().offset() + span.outputOffset().length()};
+			auto begin{span.outputOffset().offset()};
+			auto file{inputFiles.indexOf(span.file())};
+			auto group{deviceGroups.groupOf(file)};
+			for (++file; inputFiles.offsetOf(file) < end; ++file)
+			{
+				const auto nextGroup{deviceGroups.groupOf(file)};
+				const auto offset{inputFiles.offsetOf(file)};
+				// Empty inputs can change group without there being anything to cut off
+				if (nextGroup != group && offset != begin)
+				{
+					pieces.emplace_back(locateBlock({begin, offset - begin}));
+					begin = offset;
+				}
+				group = nextGroup;
+			}
+			pieces.emplace_back(locateBlock({begin, end - begin}));
+		}
+		return pieces;
+	}
 
+	int32_t chunkedCopy() noexcept try
+	{
+		const auto *const schedule{dynamic_cast<args::argSchedule_t *>(::args->find(argType_t::schedule))};
+		// The slow path has to outlive the copy workers as they feed it
+		slowPath_t slowPath{};
+		if (schedule && schedule->schedule() == args::schedule_t::guidedSpans)
+		{
+			const auto result{guidedCopy()};
+			const auto slowResult{slowPath.finish()};
+			return result ? result : slowResult;
+		}
+
+		const auto length{asUnsigned(outputFile.length())};
+		const auto processors{affinity_t{}.numProcessors()};
+		const auto size{blockSize.current()};
+
+		// An output too short for every thread to get a whole block is copied a block per span instead
+		const auto shortFile{asUnsigned(size * off_t(processors)) >= length};
+		if (shortFile)
+			console.info("Using the short file form of the algorithm"sv);
+
+		threadGroups_t copyThreads{copyChunk<chunkState_t>};
+		const auto chunksPerSpan{shortFile ? 1 : outputFile.length() / (size * off_t(processors))};
+		fileChunker_t chunker{std::size_t(chunksPerSpan * size)};
+		std::vector<chunkState_t> chunks{};
 		for (const chunkState_t &chunk : chunker)
+			chunks.emplace_back(chunk);
+		chunks = cutAtGroups(chunks);
+		// Spans are copied linearly, so the most that can be done is to start each device's spans in its order
+		if (::args->find(argType_t::physicalOrder))
+			physicalOrder(chunks, [](const chunkState_t &chunk)
+				{ return physicalLocation(chunk.outputOffset().offset()); });
+		if (::args->find(argType_t::cachedFirst))
+			cachedFirst(chunks, [](const chunkState_t &chunk) noexcept
+				{ return std::make_pair(chunk.outputOffset().offset(), chunk.outputOffset().length()); });
+
+		for (const chunkState_t &chunk : chunks)
 		{
-			if (const auto result{copyThreads.queue(chunk)}; result)
+			const auto group{deviceGroups.groupOf(std::size_t(chunk.file() - inputFiles.begin()))};
+			if (const auto result{copyThreads.queue(group, chunk)}; result)
 			{
 				console.error("Copying failed: "sv, std::strerror(result));
 				return result;
 			}
 		}
-		return copyThreads.finish();
+		const auto result{copyThreads.finish()};
+		const auto slowResult{slowPath.finish()};
+		return result ? result : slowResult;
 	}
 	catch (std::system_error &error)
 	{
@@ -10,26 +10,22 @@ namespace pcat::algorithm::chunkSpans
 	private:
 		std::size_t spanLength;
 		inputFilesIterator_t file{inputFiles.begin()};
-		off_t inputLength{file == inputFiles.end() ? 0 : file->length()};
-		mappingOffset_t inputOffset{0, blockLength(inputLength)};
+		off_t inputLength{inputFiles.lengthOf(file)};
+		mappingOffset_t inputOffset{0, blockLength(0, inputLength)};
 		const off_t outputLength{outputFile.length()};
 		mappingOffset_t outputOffset{};
 
 		[[nodiscard]] constexpr off_t spanOf(const off_t length) const noexcept
 			{ return std::min(off_t(spanLength), length); }
 
-		constexpr void nextInputBlock() noexcept
+		// Finds where in the inputs the current output block begins
+		void seekInput() noexcept
 		{
-			inputOffset += inputOffset.length();
-			if (inputOffset.offset() == inputLength)
-			{
-				assert(file != inputFiles.end()); // NOLINT
-				++file;
-				inputLength = file == inputFiles.end() ? 0 : file->length();
-				inputOffset = {};
-			}
-			inputOffset.length(blockLength(inputLength - inputOffset));
-		};
+			const auto [nextFile, offset] = inputFiles.locate(outputOffset);
+			file = nextFile;
+			inputLength = inputFiles.lengthOf(file);
+			inputOffset = {offset, blockLength(outputOffset.offset(), inputLength - offset)};
+		}
 
 	public:
 		chunking_t(const std::size_t spanLength_) noexcept : spanLength{spanLength_}
@@ -44,22 +40,16 @@ namespace pcat::algorithm::chunkSpans
 		{
 			if (outputOffset == outputLength)
 				return;
-			else if (outputOffset.length() != inputOffset.length())
-			{
-				const auto state{subchunkState().end()};
-				file = state.file();
-				inputLength = state.inputLength();
-				inputOffset = state.inputOffset();
-			}
-			if (file != inputFiles.end())
-				nextInputBlock();
 			outputOffset += outputOffset.length();
 			if (outputOffset == outputLength)
 				outputOffset.length(0);
-			else if (outputLength - outputOffset - spanLength < spanLength)
+			// Fold a short remainder into the last span, unless spans are lined up with stripes - as they are
+			// rounded to the nearest good stripe count there, a short last span is better than an overlong one
+			else if (!stripeLayout.enabled() && outputLength - outputOffset - spanLength < spanLength)
 				outputOffset.length(outputLength - outputOffset);
 			else
 				outputOffset.length(spanOf(outputLength - outputOffset));
+			seekInput();
 		}
 
 		bool operator ==(const chunking_t &other) const noexcept
@@ -78,7 +68,9 @@ namespace pcat::algorithm::chunkSpans
 		std::size_t spanLength_;
 
 	public:
-		constexpr fileChunker_t(const std::size_t spanLength) : spanLength_{spanLength} { }
+		// Spans are rounded to whole stripes when the output's stripe layout is known, so each starts on a boundary
+		fileChunker_t(const std::size_t spanLength) noexcept :
+			spanLength_{std::size_t(stripeLayout.spanLength(off_t(spanLength)))} { }
 
 		// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
 		[[nodiscard]] chunking_t begin() const noexcept { return {spanLength_}; }
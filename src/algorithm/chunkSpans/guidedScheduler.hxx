@@ -0,0 +1,156 @@
+#ifndef ALGORITHM_CHUNK_SPANS_GUIDED_SCHEDULER__HXX
+#define ALGORITHM_CHUNK_SPANS_GUIDED_SCHEDULER__HXX
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <substrate/utility>
+#include "mappingOffset.hxx"
+
+namespace pcat::algorithm::chunkSpans
+{
+	/*!
+	 * A piece is the range of the output a single worker is currently working linearly through.
+	 * The owning worker claims blocks from the front of it, while idle workers
+	 * may split off the back half of it by pulling end in.
+	 */
+	struct piece_t final
+	{
+	private:
+		std::mutex pieceMutex{};
+		off_t position_{};
+		off_t end_{};
+
+	public:
+		piece_t() noexcept = default;
+		piece_t(const piece_t &) = delete;
+		piece_t(piece_t &&) = delete;
+		~piece_t() noexcept = default;
+		piece_t &operator =(const piece_t &) = delete;
+		piece_t &operator =(piece_t &&) = delete;
+
+		void assign(const off_t begin, const off_t end) noexcept
+		{
+			std::lock_guard<std::mutex> lock{pieceMutex};
+			position_ = begin;
+			end_ = end;
+		}
+
+		[[nodiscard]] mappingOffset_t claimBlock() noexcept
+		{
+			std::lock_guard<std::mutex> lock{pieceMutex};
+			if (position_ >= end_)
+				return {end_, 0};
+			const mappingOffset_t block{position_, blockLength(position_, end_ - position_)};
+			position_ += block.length();
+			return block;
+		}
+
+		[[nodiscard]] off_t remaining() noexcept
+		{
+			std::lock_guard<std::mutex> lock{pieceMutex};
+			return end_ - position_;
+		}
+
+		// Splits the unclaimed part of this piece in two on a block boundary, returning the back half
+		[[nodiscard]] std::pair<off_t, off_t> split() noexcept
+		{
+			std::lock_guard<std::mutex> lock{pieceMutex};
+			const auto size{blockSize.current()};
+			const auto blocks{(end_ - position_) / size};
+			if (blocks < 2)
+				return {end_, end_};
+			const auto end{end_};
+			end_ = position_ + ((blocks / 2) * size);
+			return {end_, end};
+		}
+	};
+
+	/*!
+	 * The guided scheduler hands out pieces of the output sized as the remaining unassigned
+	 * length divided by the number of workers, rounded down to a whole number of transfer blocks.
+	 * This means pieces start out large, as for the static form of the algorithm, and shrink
+	 * toward the block size as the job nears its end. When the output's stripe layout is known,
+	 * pieces are also rounded to whole stripes so consecutive pieces start on different targets.
+	 *
+	 * Once the output has been entirely handed out, workers that run dry split the piece with
+	 * the most remaining work in two and take the back half, so a worker stuck on a slow
+	 * target doesn't leave everyone else sat idle.
+	 */
+	struct guidedScheduler_t final
+	{
+	private:
+		std::mutex claimMutex{};
+		const off_t outputLength;
+		off_t nextOffset{0};
+		const std::size_t workers_;
+		std::unique_ptr<piece_t []> pieces; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+		std::atomic<bool> aborted{false};
+
+		[[nodiscard]] off_t pieceLength() const noexcept
+		{
+			const auto remaining{outputLength - nextOffset};
+			const auto size{blockSize.current()};
+			const auto length{(remaining / off_t(workers_) / size) * size};
+			return std::min(remaining, stripeLayout.spanLength(std::max(length, size)));
+		}
+
+		[[nodiscard]] std::pair<off_t, off_t> steal(const std::size_t worker) noexcept
+		{
+			std::size_t victim{worker};
+			off_t mostRemaining{};
+			for (std::size_t i{}; i < workers_; ++i)
+			{
+				if (i == worker)
+					continue;
+				if (const auto remaining{pieces[i].remaining()}; remaining > mostRemaining)
+				{
+					victim = i;
+					mostRemaining = remaining;
+				}
+			}
+			if (victim == worker)
+				return {};
+			return pieces[victim].split();
+		}
+
+	public:
+		guidedScheduler_t(const off_t length, const std::size_t workers) : outputLength{length},
+			// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+			workers_{workers}, pieces{substrate::make_unique<piece_t []>(workers)} { }
+
+		[[nodiscard]] auto workers() const noexcept { return workers_; }
+		void abort() noexcept { aborted = true; }
+
+		// Assigns the next piece of work to the given worker, returning false when there is none left
+		[[nodiscard]] bool nextPiece(const std::size_t worker) noexcept
+		{
+			if (aborted)
+				return false;
+			std::lock_guard<std::mutex> lock{claimMutex};
+			if (nextOffset < outputLength)
+			{
+				const auto begin{nextOffset};
+				nextOffset += pieceLength();
+				pieces[worker].assign(begin, nextOffset);
+				return true;
+			}
+
+			const auto [begin, end] = steal(worker);
+			pieces[worker].assign(begin, end);
+			return begin != end;
+		}
+
+		// Claims the next block of the worker's current piece, which has zero length when it's finished
+		[[nodiscard]] mappingOffset_t nextBlock(const std::size_t worker) noexcept
+		{
+			if (aborted)
+				return {outputLength, 0};
+			return pieces[worker].claimBlock();
+		}
+	};
+} // namespace pcat::algorithm::chunkSpans
+
+#endif /*ALGORITHM_CHUNK_SPANS_GUIDED_SCHEDULER__HXX*/
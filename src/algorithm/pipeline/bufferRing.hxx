@@ -0,0 +1,92 @@
+#ifndef ALGORITHM_PIPELINE_BUFFER_RING__HXX
+#define ALGORITHM_PIPELINE_BUFFER_RING__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <substrate/utility>
+#include "mappingOffset.hxx"
+#include "threadedQueue.hxx"
+
+namespace pcat::algorithm::pipeline
+{
+	// A filled buffer along with the block of the output its contents belong at
+	struct filledBuffer_t final
+	{
+	private:
+		std::size_t buffer_{};
+		mappingOffset_t block_{};
+
+	public:
+		constexpr filledBuffer_t() noexcept = default;
+		constexpr filledBuffer_t(const std::size_t buffer, const mappingOffset_t &block) noexcept :
+			buffer_{buffer}, block_{block} { }
+
+		[[nodiscard]] constexpr auto buffer() const noexcept { return buffer_; }
+		[[nodiscard]] constexpr const mappingOffset_t &block() const noexcept { return block_; }
+		// A zero length block is used to tell a writer there is nothing more coming
+		[[nodiscard]] constexpr bool valid() const noexcept { return block_.length(); }
+	};
+
+	/*!
+	 * The buffer ring is a fixed set of transfer buffers shared between the reader and
+	 * writer stages of the pipeline. Readers take buffers from the free side of the ring,
+	 * fill them from the inputs and submit them to the full side, from which writers drain
+	 * them into the output before releasing them back to the free side.
+	 *
+	 * As the number of buffers is fixed, readers that get too far ahead of the writers
+	 * block waiting for a free buffer, bounding the memory used by the pipeline.
+	 */
+	struct bufferRing_t final
+	{
+	private:
+		const std::size_t count_;
+		const std::size_t bufferLength_;
+		std::unique_ptr<uint8_t []> storage; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+		threadedQueue_t<std::size_t> freeBuffers{};
+		threadedQueue_t<filledBuffer_t> fullBuffers{};
+		std::atomic<bool> aborted_{false};
+
+	public:
+		bufferRing_t(const std::size_t count, const std::size_t bufferLength) : count_{count},
+			// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+			bufferLength_{bufferLength}, storage{substrate::make_unique<uint8_t []>(count * bufferLength)}
+		{
+			for (std::size_t buffer{}; buffer < count_; ++buffer)
+				freeBuffers.push(std::size_t{buffer});
+		}
+
+		bufferRing_t(const bufferRing_t &) = delete;
+		bufferRing_t(bufferRing_t &&) = delete;
+		~bufferRing_t() noexcept = default;
+		bufferRing_t &operator =(const bufferRing_t &) = delete;
+		bufferRing_t &operator =(bufferRing_t &&) = delete;
+
+		[[nodiscard]] auto count() const noexcept { return count_; }
+		[[nodiscard]] auto bufferLength() const noexcept { return bufferLength_; }
+		[[nodiscard]] auto available() const noexcept { return freeBuffers.size(); }
+		[[nodiscard]] auto pending() const noexcept { return fullBuffers.size(); }
+		[[nodiscard]] bool aborted() const noexcept { return aborted_; }
+		void abort() noexcept { aborted_ = true; }
+
+		[[nodiscard]] uint8_t *data(const std::size_t buffer) const noexcept
+			{ return storage.get() + (buffer * bufferLength_); }
+
+		// Takes a free buffer, waiting for a writer to release one if none are available
+		[[nodiscard]] std::size_t acquire() { return freeBuffers.pop(); }
+		void submit(const std::size_t buffer, const mappingOffset_t &block) { fullBuffers.emplace(buffer, block); }
+		// Takes the next filled buffer, waiting for a reader to submit one if there are none
+		[[nodiscard]] filledBuffer_t drain() { return fullBuffers.pop(); }
+		void release(const std::size_t buffer) { freeBuffers.push(std::size_t{buffer}); }
+
+		// Tells writers that the readers are done, one notice per writer
+		void close(const std::size_t writers)
+		{
+			for (std::size_t writer{}; writer < writers; ++writer)
+				fullBuffers.emplace();
+		}
+	};
+} // namespace pcat::algorithm::pipeline
+
+#endif /*ALGORITHM_PIPELINE_BUFFER_RING__HXX*/
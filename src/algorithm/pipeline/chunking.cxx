@@ -0,0 +1,238 @@
+#include <cerrno>
+#include <string_view>
+#include <atomic>
+#include <algorithm>
+#include <substrate/console>
+#include "chunking.hxx"
+#include "mmap.hxx"
+#include "threadPool.hxx"
+#include "algorithm/chunkSpans/chunkState.hxx"
+#include "algorithm/pipeline/bufferRing.hxx"
+
+using namespace std::literals::string_view_literals;
+using substrate::console;
+
+namespace pcat::algorithm::pipeline
+{
+	/*!
+	 * The pipeline algorithm splits each block copy in two. Reader threads claim
+	 * blocks of the output in order, fill a buffer from the inputs that make up
+	 * the block and hand it on through the buffer ring. Writer threads then drain
+	 * the filled buffers into the output.
+	 *
+	 * Each stage gets its own thread count and its own processors, so the latency
+	 * of faulting in the inputs overlaps with that of writing back the output rather
+	 * than adding to it as happens when one thread does both for each block. This
+	 * matters most when the inputs and output live on different storage systems.
+	 */
+	struct pipeline_t final
+	{
+	private:
+		const off_t outputLength{outputFile.length()};
+		// The buffers are sized up front, so the block size is fixed at what it is when the pipeline is set up
+		const off_t blockLength_{blockSize.current()};
+		std::atomic<off_t> nextOffset{0};
+
+	public:
+		bufferRing_t ring;
+
+		pipeline_t(const std::size_t buffers) : ring{buffers, std::size_t(blockLength_)} { }
+
+		// Claims the next block of the output to read, which has zero length once there are none left
+		[[nodiscard]] mappingOffset_t nextBlock() noexcept
+		{
+			auto offset{nextOffset.load(std::memory_order_relaxed)};
+			off_t length{};
+			do
+			{
+				if (offset >= outputLength)
+					return {outputLength, 0};
+				// Blocks are cut to end on stripe boundaries, which only ever makes them shorter than the buffers
+				length = stripeLayout.trim(offset, std::min(blockLength_, outputLength - offset));
+			}
+			while (!nextOffset.compare_exchange_weak(offset, offset + length, std::memory_order_relaxed));
+			return {offset, length};
+		}
+	};
+
+	int32_t readBlock(uint8_t *const buffer, const mappingOffset_t &block)
+	{
+		off_t offset{};
+		for (auto chunk{chunkSpans::locateBlock(block)}; !chunk.atEnd(); ++chunk)
+		{
+			const auto index{inputFiles.indexOf(chunk.file())};
+			const auto inputFile{inputFiles.acquire(index)};
+			const auto &inputOffset = chunk.inputOffset();
+			if (!inputFile.valid())
+			{
+				const auto error = errno;
+				console.error("Failed to open source file: "sv, std::strerror(error));
+				return error;
+			}
+#ifndef _WINDOWS
+			// Small inputs cost more to map than to read, so read them straight into the buffer
+			if (inputFiles.lengthOf(index) < smallInputLength)
+			{
+				if (!readAt(*inputFile, buffer + offset, inputOffset.offset(), inputOffset.length()))
+				{
+					const auto error = errno;
+					console.error("Failed to read source file transfer chunk: "sv, std::strerror(error));
+					return error;
+				}
+				inputFiles.release(index, inputOffset.length());
+				offset += inputOffset.length();
+				continue;
+			}
+#endif
+			const mmap_t inputChunk{*inputFile, inputOffset.adjustedOffset(),
+				inputOffset.adjustedLength(), PROT_READ, MAP_PRIVATE};
+			if (!inputChunk.valid())
+			{
+				const auto error = errno;
+				console.error("Failed to map source file transfer chunk: "sv, std::strerror(error));
+				return error;
+			}
+			else if (!inputChunk.advise<MADV_SEQUENTIAL, MADV_WILLNEED, MADV_DONTDUMP>())
+			{
+				const auto error = errno;
+				console.error("Failed to advise the source map: "sv, std::strerror(error));
+				return error;
+			}
+
+			try
+				{ inputChunk.copyFrom(inputOffset.adjustment(), buffer + offset, inputOffset.length()); }
+			catch (const std::out_of_range &error)
+			{
+				console.error("Failure while reading data block: "sv, error.what());
+				return EINVAL;
+			}
+			inputFiles.release(index, inputOffset.length());
+			offset += inputOffset.length();
+		}
+		return 0;
+	}
+
+	int32_t writeBlock(const uint8_t *const buffer, const mappingOffset_t &block)
+	{
+		const mmap_t outputChunk{outputFile, block.adjustedOffset(), block.adjustedLength(), PROT_WRITE};
+		if (!outputChunk.valid())
+		{
+			const auto error = errno;
+			console.error("Failed to map destination file transfer chunk: "sv, std::strerror(error));
+			return error;
+		}
+		else if (!outputChunk.advise<MADV_SEQUENTIAL, MADV_DONTDUMP>())
+		{
+			const auto error = errno;
+			console.error("Failed to advise the destination map: "sv, std::strerror(error));
+			return error;
+		}
+
+		try
+			{ outputChunk.copyTo(block.adjustment(), buffer, block.length()); }
+		catch (const std::out_of_range &error)
+		{
+			console.error("Failure while writing data block: "sv, error.what());
+			return EINVAL;
+		}
+
+		if (sync && !outputChunk.sync())
+		{
+			const auto error = errno;
+			console.error("Failed to synchronise the mapping for region "sv, block.offset(),
+				':', block.length(), " at address "sv, outputChunk.address(0));
+			console.error("Failure reason: "sv, std::strerror(error));
+			return error;
+		}
+		return 0;
+	}
+
+	int32_t readBlocks(pipeline_t *const pipeline)
+	{
+		auto &ring{pipeline->ring};
+		for (auto block{pipeline->nextBlock()}; block.length() && !ring.aborted();
+			block = pipeline->nextBlock())
+		{
+			const auto buffer{ring.acquire()};
+			if (const auto result{readBlock(ring.data(buffer), block)}; result)
+			{
+				ring.abort();
+				ring.release(buffer);
+				return result;
+			}
+			ring.submit(buffer, block);
+			throughput::transferred(uint64_t(block.length()));
+			throughput::pace();
+		}
+		return 0;
+	}
+
+	int32_t writeBlocks(pipeline_t *const pipeline)
+	{
+		auto &ring{pipeline->ring};
+		int32_t result{};
+		for (auto filled{ring.drain()}; filled.valid(); filled = ring.drain())
+		{
+			// Once aborted, keep draining the ring so no reader is left waiting on a free buffer
+			if (!ring.aborted())
+			{
+				result = writeBlock(ring.data(filled.buffer()), filled.block());
+				if (result)
+					ring.abort();
+				throughput::transferred(uint64_t(filled.block().length()));
+			}
+			ring.release(filled.buffer());
+			throughput::pace();
+		}
+		return result;
+	}
+
+	int32_t chunkedCopy() noexcept try
+	{
+		const affinity_t affinity{};
+		const auto processors{affinity.numProcessors()};
+		const auto *const readerCount{dynamic_cast<args::argReaders_t *>(::args->find(argType_t::readers))};
+		const auto *const writerCount{dynamic_cast<args::argWriters_t *>(::args->find(argType_t::writers))};
+		// Unless told otherwise, split the processors between the stages, giving the readers any odd one out
+		const auto readers{readerCount ? readerCount->count() : std::max<std::size_t>((processors + 1) / 2, 1)};
+		const auto writers{writerCount ? writerCount->count() : std::max<std::size_t>(processors / 2, 1)};
+
+		// Two buffers per thread lets every reader be filling one while the writers drain the other
+		pipeline_t pipeline{(readers + writers) * 2};
+		threadPool_t readThreads{readBlocks, affinity_t{affinity, 0, readers}, readers};
+		threadPool_t writeThreads{writeBlocks, affinity_t{affinity, readers, writers}, writers};
+		// Each stage finds its own best thread count, as they contend for different storage
+		if (throughput::automatic())
+		{
+			readThreads.controlThroughput();
+			writeThreads.controlThroughput();
+		}
+
+		// The writers only stop once the ring is closed, so queue everything before acting on any failure
+		int32_t result{};
+		for (std::size_t reader{}; reader < readers; ++reader)
+		{
+			if (const auto readResult{readThreads.queue(&pipeline)}; readResult && !result)
+				result = readResult;
+		}
+		for (std::size_t writer{}; writer < writers; ++writer)
+		{
+			if (const auto writeResult{writeThreads.queue(&pipeline)}; writeResult && !result)
+				result = writeResult;
+		}
+
+		if (const auto readResult{readThreads.finish()}; readResult && !result)
+			result = readResult;
+		pipeline.ring.close(writers);
+		if (const auto writeResult{writeThreads.finish()}; writeResult && !result)
+			result = writeResult;
+		if (result)
+			console.error("Copying failed: "sv, std::strerror(result));
+		return result;
+	}
+	catch (std::system_error &error)
+	{
+		console.error("Copying failed: "sv, error.what());
+		return error.code().value();
+	}
+} // namespace pcat::algorithm::pipeline
@@ -26,27 +26,103 @@ auto parseOutputFile(tokenizer_t &lexer)
 	return substrate::make_unique<argOutputFile_t>(fileName);
 }
 
+auto parseFilesFrom(tokenizer_t &lexer)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Input list option given but failed to specify the file to read the list from"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	const auto fileName{token.value()};
+	lexer.next();
+	return substrate::make_unique<argFilesFrom_t>(fileName);
+}
+
 auto parseThreads(tokenizer_t &lexer)
 {
 	const auto &token{lexer.token()};
 	if (token.type() == tokenType_t::unknown)
 	{
 		// NOLINTNEXTLINE(readability-magic-numbers)
-		console.error("Thread cap option must be given a positive non-zero integer value"sv);
+		console.error("Thread cap option must be given a positive non-zero integer value or 'auto'"sv);
 		throw std::exception{};
 	}
 	lexer.next();
 	auto threadCount{substrate::make_unique<argThreads_t>(token.value())};
-	if (!threadCount->threads())
+	if (!threadCount->threads() && !threadCount->automatic())
 	{
 		// NOLINTNEXTLINE(readability-magic-numbers)
-		console.error("Thread cap option must be given a positive non-zero integer value"sv);
+		console.error("Thread cap option must be given a positive non-zero integer value or 'auto'"sv);
 		throw std::exception{};
 	}
 	lexer.next();
 	return threadCount;
 }
 
+auto parseBlockSize(tokenizer_t &lexer)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Block size option must be given 'auto' or a size to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	auto blockSize{substrate::make_unique<argBlockSize_t>(token.value())};
+	if (!blockSize->valid())
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Block size option must be given 'auto' or a multiple of 4KiB no larger than 64MiB"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	return blockSize;
+}
+
+auto parseStripeSize(tokenizer_t &lexer)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Stripe size option must be given 'auto' or a size to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	auto stripeSize{substrate::make_unique<argStripeSize_t>(token.value())};
+	if (!stripeSize->valid())
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Stripe size option must be given 'auto' or a multiple of 4KiB no larger than 4GiB"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	return stripeSize;
+}
+
+template<typename node_t> auto parseCount(tokenizer_t &lexer, const std::string_view errorMessage)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		console.error(errorMessage);
+		throw std::exception{};
+	}
+	lexer.next();
+	auto count{substrate::make_unique<node_t>(token.value())};
+	if (!count->count())
+	{
+		console.error(errorMessage);
+		throw std::exception{};
+	}
+	lexer.next();
+	return count;
+}
+
 auto parsePinning(tokenizer_t &lexer)
 {
 	const auto &token{lexer.token()};
@@ -91,6 +167,90 @@ auto parseAlgorithm(tokenizer_t &lexer)
 	return algorithm;
 }
 
+auto parseSchedule(tokenizer_t &lexer)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Schedule selection option expects the name of a schedule to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	auto schedule{substrate::make_unique<argSchedule_t>(token.value())};
+	if (!schedule->valid())
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Schedule selection option expects the name of a valid schedule to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	return schedule;
+}
+
+auto parseEngine(tokenizer_t &lexer)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Copy engine option expects the name of a copy engine to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	auto engine{substrate::make_unique<argEngine_t>(token.value())};
+	if (!engine->valid())
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Copy engine option expects the name of a valid copy engine to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	return engine;
+}
+
+auto parseSort(tokenizer_t &lexer)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Sort order option expects the name of a sort order to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	auto sort{substrate::make_unique<argSort_t>(token.value())};
+	if (!sort->valid())
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Sort order option expects the name of a valid sort order to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	return sort;
+}
+
+auto parsePlacement(tokenizer_t &lexer)
+{
+	const auto &token{lexer.token()};
+	if (token.type() == tokenType_t::unknown)
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Thread placement option expects the name of a placement to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	auto placement{substrate::make_unique<argPlacement_t>(token.value())};
+	if (!placement->valid())
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		console.error("Thread placement option expects the name of a valid placement to follow"sv);
+		throw std::exception{};
+	}
+	lexer.next();
+	return placement;
+}
+
 std::unique_ptr<argNode_t> makeNode(tokenizer_t &lexer, const option_t &option)
 {
 	lexer.next();
@@ -110,6 +270,50 @@ std::unique_ptr<argNode_t> makeNode(tokenizer_t &lexer, const option_t &option)
 			return parsePinning(lexer);
 		case argType_t::algorithm:
 			return parseAlgorithm(lexer);
+		case argType_t::schedule:
+			return parseSchedule(lexer);
+		case argType_t::deviceThreads:
+			// NOLINTNEXTLINE(readability-magic-numbers)
+			return parseCount<argDeviceThreads_t>(lexer, "Per-device thread cap option must be given a "
+				"positive non-zero integer value"sv);
+		case argType_t::stats:
+			return substrate::make_unique<argStats_t>();
+		case argType_t::readers:
+			// NOLINTNEXTLINE(readability-magic-numbers)
+			return parseCount<argReaders_t>(lexer, "Reader thread count option must be given a "
+				"positive non-zero integer value"sv);
+		case argType_t::writers:
+			// NOLINTNEXTLINE(readability-magic-numbers)
+			return parseCount<argWriters_t>(lexer, "Writer thread count option must be given a "
+				"positive non-zero integer value"sv);
+		case argType_t::maxOpen:
+			// NOLINTNEXTLINE(readability-magic-numbers)
+			return parseCount<argMaxOpen_t>(lexer, "Open input limit option must be given a "
+				"positive non-zero integer value"sv);
+		case argType_t::filesFrom:
+			return parseFilesFrom(lexer);
+		case argType_t::recursive:
+			return substrate::make_unique<argRecursive_t>();
+		case argType_t::cachedFirst:
+			return substrate::make_unique<argCachedFirst_t>();
+		case argType_t::physicalOrder:
+			return substrate::make_unique<argPhysicalOrder_t>();
+		case argType_t::placement:
+			return parsePlacement(lexer);
+		case argType_t::verbose:
+			return substrate::make_unique<argVerbose_t>();
+		case argType_t::sort:
+			return parseSort(lexer);
+		case argType_t::engine:
+			return parseEngine(lexer);
+		case argType_t::blockSize:
+			return parseBlockSize(lexer);
+		case argType_t::stripeSize:
+			return parseStripeSize(lexer);
+		case argType_t::stripeCount:
+			// NOLINTNEXTLINE(readability-magic-numbers)
+			return parseCount<argStripeCount_t>(lexer, "Stripe count option must be given a "
+				"positive non-zero integer value"sv);
 		default:
 			throw std::exception{};
 	}
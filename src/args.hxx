@@ -19,13 +19,62 @@ namespace pcat::args
 		async,
 		threads,
 		pinning,
-		algorithm
+		algorithm,
+		schedule,
+		deviceThreads,
+		stats,
+		readers,
+		writers,
+		maxOpen,
+		filesFrom,
+		recursive,
+		sort,
+		engine,
+		cachedFirst,
+		placement,
+		verbose,
+		blockSize,
+		stripeSize,
+		stripeCount,
+		physicalOrder
 	};
 
 	enum class algorithm_t : uint8_t
 	{
 		blockLinear,
 		chunkSpans,
+		pipeline,
+		automatic,
+		invalid
+	};
+
+	enum class schedule_t : uint8_t
+	{
+		staticSpans,
+		guidedSpans,
+		invalid
+	};
+
+	enum class engine_t : uint8_t
+	{
+		mmap,
+		nowait,
+		invalid
+	};
+
+	enum class placement_t : uint8_t
+	{
+		cores,
+		threads,
+		compact,
+		scatter,
+		invalid
+	};
+
+	enum class sort_t : uint8_t
+	{
+		lexical,
+		natural,
 		invalid
 	};
 
@@ -89,15 +138,60 @@ namespace pcat::args
 		[[nodiscard]] constexpr auto fileName() const noexcept { return fileName_; }
 	};
 
+	struct argFilesFrom_t final : argNode_t
+	{
+	private:
+		std::string_view fileName_;
+
+	public:
+		argFilesFrom_t() = delete;
+		constexpr argFilesFrom_t(const std::string_view fileName) noexcept :
+			argNode_t{argType_t::filesFrom}, fileName_{fileName} { }
+		[[nodiscard]] constexpr auto fileName() const noexcept { return fileName_; }
+	};
+
 	struct argThreads_t final : argNode_t
 	{
 	private:
 		std::size_t threads_{};
+		bool automatic_{false};
 
 	public:
 		argThreads_t() = delete;
 		argThreads_t(std::string_view threads) noexcept;
+		// The thread cap, which is 0 when the count is left to the throughput controller
 		[[nodiscard]] auto threads() const noexcept { return threads_; }
+		[[nodiscard]] auto automatic() const noexcept { return automatic_; }
+	};
+
+	struct argBlockSize_t final : argNode_t
+	{
+	private:
+		std::size_t size_{};
+		bool automatic_{false};
+
+	public:
+		argBlockSize_t() = delete;
+		argBlockSize_t(std::string_view size) noexcept;
+		[[nodiscard]] bool valid() const noexcept;
+		// The block size in bytes, which is 0 when it is to be tuned as the copy runs
+		[[nodiscard]] auto size() const noexcept { return size_; }
+		[[nodiscard]] auto automatic() const noexcept { return automatic_; }
+	};
+
+	struct argStripeSize_t final : argNode_t
+	{
+	private:
+		std::size_t size_{};
+		bool automatic_{false};
+
+	public:
+		argStripeSize_t() = delete;
+		argStripeSize_t(std::string_view size) noexcept;
+		[[nodiscard]] bool valid() const noexcept;
+		// The stripe size in bytes, which is 0 when it is to be found out from the output
+		[[nodiscard]] auto size() const noexcept { return size_; }
+		[[nodiscard]] auto automatic() const noexcept { return automatic_; }
 	};
 
 	struct argPinning_t final : argNode_t
@@ -127,15 +221,89 @@ namespace pcat::args
 		[[nodiscard]] auto algorithm() const noexcept { return algorithm_; }
 	};
 
+	struct argSchedule_t final : argNode_t
+	{
+	private:
+		schedule_t schedule_{schedule_t::staticSpans};
+
+	public:
+		argSchedule_t() = delete;
+		argSchedule_t(std::string_view schedule) noexcept;
+		[[nodiscard]] auto valid() const noexcept { return schedule_ != schedule_t::invalid; }
+		[[nodiscard]] auto schedule() const noexcept { return schedule_; }
+	};
+
+	struct argEngine_t final : argNode_t
+	{
+	private:
+		engine_t engine_{engine_t::mmap};
+
+	public:
+		argEngine_t() = delete;
+		argEngine_t(std::string_view engine) noexcept;
+		[[nodiscard]] auto valid() const noexcept { return engine_ != engine_t::invalid; }
+		[[nodiscard]] auto engine() const noexcept { return engine_; }
+	};
+
+	struct argPlacement_t final : argNode_t
+	{
+	private:
+		placement_t placement_{placement_t::cores};
+
+	public:
+		argPlacement_t() = delete;
+		argPlacement_t(std::string_view placement) noexcept;
+		[[nodiscard]] auto valid() const noexcept { return placement_ != placement_t::invalid; }
+		[[nodiscard]] auto placement() const noexcept { return placement_; }
+	};
+
+	struct argSort_t final : argNode_t
+	{
+	private:
+		sort_t sort_{sort_t::lexical};
+
+	public:
+		argSort_t() = delete;
+		argSort_t(std::string_view sort) noexcept;
+		[[nodiscard]] auto valid() const noexcept { return sort_ != sort_t::invalid; }
+		[[nodiscard]] auto sort() const noexcept { return sort_; }
+	};
+
 	template<argType_t argType> struct argOfType_t final : argNode_t
 	{
 	public:
 		constexpr argOfType_t() noexcept : argNode_t{argType} { }
 	};
 
+	// Converts a decimal count given on the command line, yielding 0 if the value was not valid
+	[[nodiscard]] extern std::size_t toCount(std::string_view value) noexcept;
+	// Converts a size given in bytes, or KiB, MiB or GiB with a k, m or g suffix, yielding 0 if over maximum
+	[[nodiscard]] extern std::size_t toSize(std::string_view value, std::size_t maximum) noexcept;
+
+	template<argType_t argType> struct argCount_t final : argNode_t
+	{
+	private:
+		std::size_t count_{};
+
+	public:
+		argCount_t() = delete;
+		argCount_t(const std::string_view value) noexcept : argNode_t{argType}, count_{toCount(value)} { }
+		[[nodiscard]] auto count() const noexcept { return count_; }
+	};
+
 	using argHelp_t = argOfType_t<argType_t::help>;
 	using argVersion_t = argOfType_t<argType_t::version>;
 	using argAsync_t = argOfType_t<argType_t::async>;
+	using argStats_t = argOfType_t<argType_t::stats>;
+	using argRecursive_t = argOfType_t<argType_t::recursive>;
+	using argCachedFirst_t = argOfType_t<argType_t::cachedFirst>;
+	using argVerbose_t = argOfType_t<argType_t::verbose>;
+	using argPhysicalOrder_t = argOfType_t<argType_t::physicalOrder>;
+	using argDeviceThreads_t = argCount_t<argType_t::deviceThreads>;
+	using argReaders_t = argCount_t<argType_t::readers>;
+	using argWriters_t = argCount_t<argType_t::writers>;
+	using argMaxOpen_t = argCount_t<argType_t::maxOpen>;
+	using argStripeCount_t = argCount_t<argType_t::stripeCount>;
 
 	struct option_t final
 	{
@@ -1,8 +1,12 @@
 #include <substrate/conversions>
+#include <substrate/units>
 #include "../args.hxx"
+#include "../blockSize.hxx"
+#include "../stripeLayout.hxx"
 
 using namespace std::literals::string_view_literals;
 using substrate::toInt_t;
+using substrate::operator ""_GiB;
 
 namespace pcat::args
 {
@@ -21,8 +25,66 @@ namespace pcat::args
 	catch (std::bad_alloc &)
 		{ return false; }
 
+	std::size_t toCount(const std::string_view value) noexcept
+		{ return toInt_t<size_t>{value.data(), value.size()}.fromDec(); }
+
 	argThreads_t::argThreads_t(const std::string_view threads) noexcept : argNode_t{argType_t::threads}
-		{ threads_ = toInt_t<size_t>{threads.data(), threads.size()}.fromDec(); }
+	{
+		if (threads == "auto"sv)
+			automatic_ = true;
+		else
+			threads_ = toInt_t<size_t>{threads.data(), threads.size()}.fromDec();
+	}
+
+	std::size_t toSize(const std::string_view value, const std::size_t maximum) noexcept
+	{
+		auto digits{value};
+		std::size_t multiplier{1U};
+		if (!digits.empty())
+		{
+			const auto suffix{digits.back()};
+			if (suffix == 'k' || suffix == 'K')
+				multiplier = 1_KiB;
+			else if (suffix == 'm' || suffix == 'M')
+				multiplier = 1_MiB;
+			else if (suffix == 'g' || suffix == 'G')
+				multiplier = 1_GiB;
+			if (multiplier != 1U)
+				digits.remove_suffix(1);
+		}
+		const auto count{toCount(digits)};
+		// Checking against maximum before multiplying also keeps anything big enough to overflow out
+		if (count > maximum / multiplier)
+			return 0U;
+		return count * multiplier;
+	}
+
+	argBlockSize_t::argBlockSize_t(const std::string_view size) noexcept : argNode_t{argType_t::blockSize}
+	{
+		if (size == "auto"sv)
+			automatic_ = true;
+		else
+			size_ = toSize(size, std::size_t(maximumBlockSize));
+	}
+
+	// Block sizes must be a whole number of pages, and no larger than the largest block size pcat will use
+	bool argBlockSize_t::valid() const noexcept
+	{
+		return automatic_ ||
+			(size_ && !(size_ % 4_KiB) && size_ <= std::size_t(maximumBlockSize));
+	}
+
+	argStripeSize_t::argStripeSize_t(const std::string_view size) noexcept : argNode_t{argType_t::stripeSize}
+	{
+		if (size == "auto"sv)
+			automatic_ = true;
+		else
+			size_ = toSize(size, std::size_t(maximumStripeSize));
+	}
+
+	// Stripe sizes must be a whole number of pages, as both Lustre and GPFS require
+	bool argStripeSize_t::valid() const noexcept
+		{ return automatic_ || (size_ && !(size_ % 4_KiB)); }
 
 	argPinning_t::argPinning_t(const std::string_view threads) noexcept : argNode_t{argType_t::pinning}, cores_{}
 	{
@@ -51,7 +113,55 @@ namespace pcat::args
 			algorithm_ = algorithm_t::blockLinear;
 		else if (algorithm == "chunkSpans"sv)
 			algorithm_ = algorithm_t::chunkSpans;
+		else if (algorithm == "pipeline"sv)
+			algorithm_ = algorithm_t::pipeline;
+		else if (algorithm == "auto"sv)
+			algorithm_ = algorithm_t::automatic;
 		else
 			algorithm_ = algorithm_t::invalid;
 	}
+
+	argSchedule_t::argSchedule_t(const std::string_view schedule) noexcept : argNode_t{argType_t::schedule}
+	{
+		if (schedule == "static"sv)
+			schedule_ = schedule_t::staticSpans;
+		else if (schedule == "guided"sv)
+			schedule_ = schedule_t::guidedSpans;
+		else
+			schedule_ = schedule_t::invalid;
+	}
+
+	argEngine_t::argEngine_t(const std::string_view engine) noexcept : argNode_t{argType_t::engine}
+	{
+		if (engine == "mmap"sv)
+			engine_ = engine_t::mmap;
+		else if (engine == "nowait"sv)
+			engine_ = engine_t::nowait;
+		else
+			engine_ = engine_t::invalid;
+	}
+
+	argPlacement_t::argPlacement_t(const std::string_view placement) noexcept : argNode_t{argType_t::placement}
+	{
+		if (placement == "cores"sv)
+			placement_ = placement_t::cores;
+		else if (placement == "threads"sv)
+			placement_ = placement_t::threads;
+		else if (placement == "compact"sv)
+			placement_ = placement_t::compact;
+		else if (placement == "scatter"sv)
+			placement_ = placement_t::scatter;
+		else
+			placement_ = placement_t::invalid;
+	}
+
+	argSort_t::argSort_t(const std::string_view sort) noexcept : argNode_t{argType_t::sort}
+	{
+		if (sort == "lexical"sv)
+			sort_ = sort_t::lexical;
+		else if (sort == "natural"sv)
+			sort_ = sort_t::natural;
+		else
+			sort_ = sort_t::invalid;
+	}
 } // namespace pcat::args
@@ -0,0 +1,129 @@
+#ifndef BLOCK_SIZE__HXX
+#define BLOCK_SIZE__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <substrate/fd>
+#include <substrate/units>
+
+namespace pcat
+{
+	using substrate::off_t;
+	using substrate::operator ""_KiB;
+	using substrate::operator ""_MiB;
+	using namespace std::literals::chrono_literals;
+
+	// The block size used unless told otherwise with --block-size
+	constexpr static auto transferBlockSize{off_t(1_MiB)};
+	// The smallest block size --block-size=auto will go down to, and the largest any block may be
+	constexpr static auto minimumBlockSize{off_t(64_KiB)};
+	constexpr static auto maximumBlockSize{off_t(64_MiB)};
+
+	/*!
+	 * The size of the blocks the output is copied in. By default this is transferBlockSize,
+	 * fixed for the whole copy. With --block-size=auto, it starts out from the largest
+	 * preferred IO size of the output and inputs, which on Lustre and GPFS is the stripe or
+	 * filesystem block size, and is then tuned as the copy runs from how long each block
+	 * takes. Blocks that copy in next to no time are dominated by the cost of setting them
+	 * up, so the size doubles, while blocks that take a long time leave workers idle at the
+	 * tail of the copy waiting on the last of them, so the size halves.
+	 *
+	 * The size only ever moves in whole multiples of the preferred IO size, and is kept
+	 * small enough that every worker gets several blocks so the tail stays balanced.
+	 */
+	struct blockSize_t final
+	{
+	public:
+		// How many full blocks are timed between each adjustment of the size
+		constexpr static std::size_t sampleBlocks{8U};
+		// Blocks that take less than this on average are too small, and more than this too large
+		constexpr static auto fastBlock{2ms};
+		constexpr static auto slowBlock{50ms};
+		// How many blocks each worker should have at least, so the copy's tail balances out
+		constexpr static off_t tailBlocks{8};
+
+	private:
+		std::atomic<off_t> size_{transferBlockSize};
+		std::atomic<bool> adaptive_{false};
+		off_t granule_{minimumBlockSize};
+		off_t minimum_{minimumBlockSize};
+		off_t maximum_{maximumBlockSize};
+		std::mutex sampleMutex{};
+		std::size_t samples{0};
+		std::chrono::nanoseconds sampleTime{};
+
+		[[nodiscard]] off_t roundDown(const off_t size) const noexcept { return (size / granule_) * granule_; }
+		[[nodiscard]] off_t roundUp(const off_t size) const noexcept
+			{ return ((size + granule_ - 1) / granule_) * granule_; }
+
+	public:
+		blockSize_t() noexcept = default;
+		blockSize_t(const blockSize_t &) = delete;
+		blockSize_t(blockSize_t &&) = delete;
+		~blockSize_t() noexcept = default;
+		blockSize_t &operator =(const blockSize_t &) = delete;
+		blockSize_t &operator =(blockSize_t &&) = delete;
+
+		[[nodiscard]] off_t current() const noexcept { return size_.load(std::memory_order_relaxed); }
+		[[nodiscard]] bool adaptive() const noexcept { return adaptive_.load(std::memory_order_relaxed); }
+		[[nodiscard]] auto minimum() const noexcept { return minimum_; }
+		[[nodiscard]] auto maximum() const noexcept { return maximum_; }
+
+		// Fixes the block size for the whole copy, as for --block-size with a size
+		void fixed(const off_t size) noexcept
+		{
+			size_ = std::clamp(size, off_t(4_KiB), maximumBlockSize);
+			adaptive_ = false;
+		}
+
+		/*!
+		 * Sets the block size up for tuning as the copy runs, as for --block-size=auto, given the
+		 * largest preferred IO size of the output and inputs, the length of the output, and how
+		 * many workers will be copying it.
+		 */
+		void adapt(const off_t preferred, const off_t outputLength, const std::size_t workers) noexcept
+		{
+			granule_ = std::clamp(preferred, off_t(4_KiB), maximumBlockSize);
+			minimum_ = roundUp(minimumBlockSize);
+			const auto balanced{roundDown(outputLength / (off_t(std::max<std::size_t>(workers, 1U)) * tailBlocks))};
+			maximum_ = std::max(std::min(roundDown(maximumBlockSize), balanced), minimum_);
+			size_ = std::clamp(roundUp(std::max(transferBlockSize, granule_)), minimum_, maximum_);
+			std::lock_guard<std::mutex> lock{sampleMutex};
+			samples = 0;
+			sampleTime = {};
+			adaptive_ = true;
+		}
+
+		/*!
+		 * Records how long a block of length bytes took to copy. Only full blocks say anything
+		 * about the block size, so those cut short by the end of an input or the output are
+		 * ignored. Once enough have been timed, the size is doubled or halved if they took too
+		 * little or too long on average.
+		 */
+		void completed(const off_t length, const std::chrono::nanoseconds elapsed) noexcept
+		{
+			if (!adaptive() || length < current())
+				return;
+			std::lock_guard<std::mutex> lock{sampleMutex};
+			sampleTime += elapsed;
+			if (++samples < sampleBlocks)
+				return;
+			const auto average{sampleTime / samples};
+			samples = 0;
+			sampleTime = {};
+			const auto size{current()};
+			if (average < fastBlock && size * 2 <= maximum_)
+				size_ = size * 2;
+			else if (average > slowBlock && size > minimum_)
+				size_ = std::max(roundDown(size / 2), minimum_);
+		}
+	};
+
+	extern blockSize_t blockSize;
+} // namespace pcat
+
+#endif /*BLOCK_SIZE__HXX*/
@@ -6,6 +6,10 @@
 #include <sys/types.h>
 #include <substrate/fd>
 #include <substrate/units>
+#include "inputFiles.hxx"
+#include "deferredReads.hxx"
+#include "blockSize.hxx"
+#include "stripeLayout.hxx"
 
 namespace pcat
 {
@@ -19,13 +23,17 @@ namespace pcat
 #else
 	constexpr static auto pageSize{off_t(64_KiB)};
 #endif
-	constexpr static auto transferBlockSize{off_t(1_MiB)};
-	extern std::vector<fd_t> inputFiles;
+	// Inputs smaller than this are read rather than mapped, as setting up and tearing down a mapping costs more
+	constexpr static auto smallInputLength{off_t(64_KiB)};
+	extern inputFiles_t inputFiles;
 	extern fd_t outputFile;
 	extern std::atomic<bool> sync;
 
-	constexpr off_t blockLength(const off_t length)
-		{ return std::min(transferBlockSize, length); }
+	inline off_t blockLength(const off_t length) noexcept
+		{ return std::min(blockSize.current(), length); }
+	// The length of the block of the output starting at offset with length bytes left, cut to stripe boundaries
+	inline off_t blockLength(const off_t offset, const off_t length) noexcept
+		{ return stripeLayout.trim(offset, blockLength(length)); }
 
 	using inputFilesIterator_t = typename decltype(inputFiles)::iterator;
 
@@ -33,6 +41,7 @@ namespace pcat
 	{
 		namespace blockLinear { extern int32_t chunkedCopy() noexcept; }
 		namespace chunkSpans { extern int32_t chunkedCopy() noexcept; }
+		namespace pipeline { extern int32_t chunkedCopy() noexcept; }
 	}
 } // namespace pcat
 
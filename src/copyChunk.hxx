@@ -3,19 +3,269 @@
 
 #include <cerrno>
 #include <string_view>
+#include <optional>
+#include <memory>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+#ifndef _WINDOWS
+#	include <fcntl.h>
+#endif
+#include <substrate/utility>
 #include <substrate/console>
 #include "chunking.hxx"
+#include "mappingOffset.hxx"
 #include "mmap.hxx"
+#include "args.hxx"
+#include "threadPool.hxx"
 
 using namespace std::literals::string_view_literals;
 using substrate::console;
 
 namespace pcat::algorithm
 {
+	/*!
+	 * Asks the kernel to start reading in the given range of an input ahead of it being mapped.
+	 * This is purely advisory, so failures are ignored - at worst the first touch of the
+	 * mapping faults the data in as it would have without it.
+	 */
+	inline void prefetchInput([[maybe_unused]] const fd_t &file,
+		[[maybe_unused]] const mappingOffset_t &inputOffset) noexcept
+	{
+#ifndef _WINDOWS
+		posix_fadvise(file, inputOffset.adjustedOffset(), inputOffset.adjustedLength(), POSIX_FADV_WILLNEED);
+#endif
+	}
+
+	// Copies a sub-chunk of an input into the output mapping by mapping the input
+	inline int32_t copyMapped(const fd_t &inputFile, const mappingOffset_t &inputOffset,
+		const mmap_t &outputChunk, const off_t offset)
+	{
+		const mmap_t inputChunk{inputFile, inputOffset.adjustedOffset(),
+			inputOffset.adjustedLength(), PROT_READ, MAP_PRIVATE};
+		if (!inputChunk.valid())
+		{
+			const auto error = errno;
+			console.error("Failed to map source file transfer chunk: "sv, std::strerror(error));
+			return error;
+		}
+		else if (!inputChunk.advise<MADV_SEQUENTIAL, MADV_WILLNEED, MADV_DONTDUMP>())
+		{
+			const auto error = errno;
+			console.error("Failed to advise the source map: "sv, std::strerror(error));
+			return error;
+		}
+
+		try
+		{
+			outputChunk.copyTo(
+				offset,
+				inputChunk.address(inputOffset.adjustment()),
+				inputOffset.length()
+			);
+		}
+		catch (const std::out_of_range &error)
+		{
+			console.error("Failure while copying data block: "sv, error.what());
+			return EINVAL;
+		}
+		return 0;
+	}
+
+	/*!
+	 * Copies a sub-chunk of a small input into the output mapping with pread(). For inputs
+	 * of only a few KiB, the mmap() and munmap() of the mapping path cost more than the data
+	 * itself, while the output mapping already covers every input in the chunk, so a run of
+	 * small inputs is packed into the one mapping and written back together.
+	 */
+	inline int32_t copyRead(const fd_t &inputFile, const mappingOffset_t &inputOffset,
+		const mmap_t &outputChunk, const off_t offset)
+	{
+#ifndef _WINDOWS
+		try
+		{
+			if (!outputChunk.fill(offset, inputFile, inputOffset.offset(), inputOffset.length()))
+			{
+				const auto error = errno;
+				console.error("Failed to read source file transfer chunk: "sv, std::strerror(error));
+				return error;
+			}
+		}
+		catch (const std::out_of_range &error)
+		{
+			console.error("Failure while copying data block: "sv, error.what());
+			return EINVAL;
+		}
+		return 0;
+#else
+		return copyMapped(inputFile, inputOffset, outputChunk, offset);
+#endif
+	}
+
+	// Reads for the nowait engine go through this rather than straight into the output mapping
+	// as faulting in the mapping's pages is itself something that has to wait. It grows to fit
+	// the largest sub-chunk the thread has read, as the block size may change during the copy.
+	[[nodiscard]] inline uint8_t *stagingBuffer(const off_t length)
+	{
+		// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+		thread_local std::unique_ptr<uint8_t []> buffer{};
+		thread_local off_t capacity{0};
+		if (length > capacity)
+		{
+			// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+			buffer = substrate::make_unique<uint8_t []>(std::size_t(length));
+			capacity = length;
+		}
+		return buffer.get();
+	}
+
+#ifndef _WINDOWS
+	/*!
+	 * Copies what of a sub-chunk of an input is in the page cache into the output mapping,
+	 * handing the rest off to the slow path, and gives back in copied how much was copied
+	 * here. The bytes read here are released from the input straight away, while those
+	 * deferred are released, and counted towards the throughput, by the slow path once it
+	 * reads them.
+	 */
+	inline int32_t copyCached(const std::size_t index, const fd_t &inputFile, const mappingOffset_t &inputOffset,
+		const mmap_t &outputChunk, const off_t outputBase, const off_t offset, off_t &copied)
+	{
+		try
+		{
+			const auto length{inputOffset.length()};
+			auto *const buffer{stagingBuffer(length)};
+			const auto amount{readCachedAt(inputFile, buffer, inputOffset.offset(), length)};
+			if (amount < 0)
+			{
+				const auto error = errno;
+				console.error("Failed to read source file transfer chunk: "sv, std::strerror(error));
+				return error;
+			}
+			outputChunk.copyTo(offset, buffer, amount);
+			if (amount < length)
+				deferredReads.defer(index, inputOffset.offset() + amount,
+					outputBase + offset + amount, length - amount, throughput::counter());
+			inputFiles.release(index, amount);
+			copied = amount;
+		}
+		catch (const std::out_of_range &error)
+		{
+			console.error("Failure while copying data block: "sv, error.what());
+			return EINVAL;
+		}
+		return 0;
+	}
+
+	// Services the slow path, reading the ranges deferred by copyCached() and writing them to the output
+	inline int32_t copyDeferred(deferredReads_t *const reads)
+	{
+		int32_t result{};
+		for (auto read{reads->next()}; read.valid(); read = reads->next())
+		{
+			// Once something's gone wrong, keep taking reads so every worker still gets its notice to stop
+			if (result)
+				continue;
+			const mappingOffset_t outputOffset{read.outputOffset(), read.length()};
+			const mmap_t outputChunk{outputFile, outputOffset.adjustedOffset(),
+				outputOffset.adjustedLength(), PROT_WRITE};
+			const auto inputFile{inputFiles.acquire(read.input())};
+			if (!outputChunk.valid() || !inputFile.valid())
+			{
+				result = errno;
+				console.error("Failed to set up deferred read: "sv, std::strerror(result));
+				continue;
+			}
+
+			const auto begin{std::chrono::steady_clock::now()};
+			try
+			{
+				if (!outputChunk.fill(outputOffset.adjustment(), *inputFile, read.inputOffset(), read.length()))
+				{
+					result = errno;
+					console.error("Failed to read source file transfer chunk: "sv, std::strerror(result));
+					continue;
+				}
+			}
+			catch (const std::out_of_range &error)
+			{
+				console.error("Failure while copying deferred data block: "sv, error.what());
+				result = EINVAL;
+				continue;
+			}
+
+			if (sync && !outputChunk.sync())
+			{
+				result = errno;
+				console.error("Failed to synchronise the mapping for region "sv, outputOffset.offset(),
+					':', outputOffset.length(), " at address "sv, outputChunk.address(0));
+				console.error("Failure reason: "sv, std::strerror(result));
+				continue;
+			}
+			inputFiles.release(read.input(), read.length());
+			// The copy workers only count what they copied themselves, so the rest is counted as it's done here
+			if (blockSize.adaptive())
+				blockSize.completed(read.length(), std::chrono::steady_clock::now() - begin);
+			read.transferred();
+		}
+		return result;
+	}
+#endif
+
+	/*!
+	 * Brings up the slow path workers for the nowait engine when it's been asked for, and
+	 * otherwise does nothing. As these spend their time waiting on storage rather than
+	 * copying, there are twice as many of them as there are processors to run the copy on.
+	 * finish() must only be called once the copy workers are done deferring reads.
+	 *
+	 * Windows has no way to read only what's cached, so there the nowait engine falls back
+	 * to mmap and no slow path is brought up.
+	 */
+	struct slowPath_t final
+	{
+	private:
+		std::size_t workers_{0};
+		std::optional<threadPool_t<int32_t(deferredReads_t *)>> threads{};
+
+	public:
+		slowPath_t()
+		{
+#ifndef _WINDOWS
+			const auto *const engine{dynamic_cast<args::argEngine_t *>(::args->find(argType_t::engine))};
+			if (!engine || engine->engine() != args::engine_t::nowait)
+				return;
+			const affinity_t affinity{};
+			workers_ = std::max<std::size_t>(affinity.numProcessors() * 2U, 1U);
+			threads.emplace(copyDeferred, affinity_t{affinity, 0, workers_}, workers_);
+			deferredReads.enable(true);
+			for (std::size_t worker{}; worker < workers_; ++worker)
+				[[maybe_unused]] const auto result{threads->queue(&deferredReads)};
+#endif
+		}
+
+		slowPath_t(const slowPath_t &) = delete;
+		slowPath_t(slowPath_t &&) = delete;
+		~slowPath_t() noexcept { [[maybe_unused]] const auto result{finish()}; }
+		slowPath_t &operator =(const slowPath_t &) = delete;
+		slowPath_t &operator =(slowPath_t &&) = delete;
+
+		[[nodiscard]] auto workers() const noexcept { return workers_; }
+
+		[[nodiscard]] int32_t finish()
+		{
+			if (!threads)
+				return 0;
+			deferredReads.enable(false);
+			deferredReads.close(workers_);
+			const auto result{threads->finish()};
+			threads.reset();
+			return result;
+		}
+	};
+
 	template<typename chunkState_t> int32_t copyChunk(chunkState_t chunk)
 	{
 		const auto &outputOffset = chunk.outputOffset();
-		[[maybe_unused]] const auto outputLength{outputOffset.length()};
+		[[maybe_unused]] const auto outputLength{outputOffset.adjustedLength()};
 		const mmap_t outputChunk{outputFile, outputOffset.adjustedOffset(),
 			outputOffset.adjustedLength(), PROT_WRITE};
 		if (!outputChunk.valid())
@@ -31,42 +281,63 @@ namespace pcat::algorithm
 			return error;
 		}
 
+		// outputOffset follows the chunk along as it's copied, so note where the mapping starts in the output first
+		[[maybe_unused]] const auto outputBase{outputOffset.adjustedOffset()};
 		auto offset{outputOffset.adjustment()};
+		bool started{false};
 		while (!chunk.atEnd())
 		{
-			const auto &inputFile = chunk.inputFile();
+			// Between sub-chunks is where --threads=auto may park us, as no input is held there
+			if (std::exchange(started, true))
+				throughput::pace();
+			const auto index{inputFiles.indexOf(chunk.file())};
+			const auto inputFile{inputFiles.acquire(index)};
 			const auto &inputOffset = chunk.inputOffset();
-			const mmap_t inputChunk{inputFile, inputOffset.adjustedOffset(),
-				inputOffset.adjustedLength(), PROT_READ, MAP_PRIVATE};
-			if (!inputChunk.valid())
-			{
-				const auto error = errno;
-				console.error("Failed to map source file transfer chunk: "sv, std::strerror(error));
-				return error;
-			}
-			else if (!inputChunk.advise<MADV_SEQUENTIAL, MADV_WILLNEED, MADV_DONTDUMP>())
+			if (!inputFile.valid())
 			{
 				const auto error = errno;
-				console.error("Failed to advise the source map: "sv, std::strerror(error));
+				console.error("Failed to open source file: "sv, std::strerror(error));
 				return error;
 			}
 
-			try
+			// Get the next sub-chunk in flight while we copy this one so we don't stall on its first fault
+			// (lazily opened inputs might not be open yet, so are left to fault in as they are mapped). This only
+			// reaches as far as the end of the chunk - blockLinear's workers prefetch their next block themselves
+			auto nextChunk{chunk};
+			++nextChunk;
+			if (!nextChunk.atEnd() && !inputFiles.lazy())
+				prefetchInput(nextChunk.inputFile(), nextChunk.inputOffset());
+
+			// How much of the sub-chunk was copied here, rather than being left to the slow path
+			auto copied{inputOffset.length()};
+			const auto begin{std::chrono::steady_clock::now()};
+#ifndef _WINDOWS
+			if (deferredReads.enabled())
 			{
-				outputChunk.copyTo(
-					offset,
-					inputChunk.address(inputOffset.adjustment()),
-					inputOffset.length()
-				);
+				if (const auto result
+					{copyCached(index, *inputFile, inputOffset, outputChunk, outputBase, offset, copied)}; result)
+					return result;
 			}
-			catch (const std::out_of_range &error)
+			else
+#endif
 			{
-				console.error("Failure while copying data block: "sv, error.what());
-				return EINVAL;
+				const auto result
+				{
+					inputFiles.lengthOf(index) < smallInputLength ?
+						copyRead(*inputFile, inputOffset, outputChunk, offset) :
+						copyMapped(*inputFile, inputOffset, outputChunk, offset)
+				};
+				if (result)
+					return result;
+				inputFiles.release(index, inputOffset.length());
 			}
+			// Let --block-size=auto know how long this sub-chunk took, so it can tune the block size
+			if (blockSize.adaptive())
+				blockSize.completed(copied, std::chrono::steady_clock::now() - begin);
+			throughput::transferred(uint64_t(copied));
 			offset += inputOffset.length();
 			assert(offset <= outputLength);
-			++chunk;
+			chunk = nextChunk;
 		}
 
 		if (sync && !outputChunk.sync())
@@ -0,0 +1,85 @@
+#ifndef DEFERRED_READS__HXX
+#define DEFERRED_READS__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <substrate/fd>
+#include "threadedQueue.hxx"
+
+namespace pcat
+{
+	using substrate::off_t;
+
+	// The count of bytes transferred by the pool a deferred read came from, which is null if it isn't counting
+	using byteCounter_t = std::shared_ptr<std::atomic<uint64_t>>;
+
+	// A range of an input that could not be read without waiting on storage, along with where it belongs in the output
+	struct deferredRead_t final
+	{
+	private:
+		std::size_t input_{};
+		off_t inputOffset_{};
+		off_t outputOffset_{};
+		off_t length_{};
+		byteCounter_t counter_{};
+
+	public:
+		deferredRead_t() noexcept = default;
+		deferredRead_t(const std::size_t input, const off_t inputOffset, const off_t outputOffset,
+			const off_t length, byteCounter_t counter) noexcept : input_{input}, inputOffset_{inputOffset},
+			outputOffset_{outputOffset}, length_{length}, counter_{std::move(counter)} { }
+
+		[[nodiscard]] auto input() const noexcept { return input_; }
+		[[nodiscard]] auto inputOffset() const noexcept { return inputOffset_; }
+		[[nodiscard]] auto outputOffset() const noexcept { return outputOffset_; }
+		[[nodiscard]] auto length() const noexcept { return length_; }
+		// A zero length read is used to tell a slow path worker there is nothing more coming
+		[[nodiscard]] bool valid() const noexcept { return length_; }
+
+		// Counts the read towards the throughput of the pool that deferred it, now it's been done
+		void transferred() const noexcept
+		{
+			if (counter_)
+				counter_->fetch_add(uint64_t(length_), std::memory_order_relaxed);
+		}
+	};
+
+	/*!
+	 * The deferred reads queue is the slow path of the nowait engine. Copy workers read
+	 * what they can of each input straight out of the page cache, and any range that would
+	 * have had to wait on storage is queued here instead, for a separate and larger set of
+	 * workers to read. This keeps a few cold ranges from holding up workers that could be
+	 * copying the hot ones.
+	 */
+	struct deferredReads_t final
+	{
+	private:
+		threadedQueue_t<deferredRead_t> reads{};
+		std::atomic<bool> enabled_{false};
+
+	public:
+		[[nodiscard]] bool enabled() const noexcept { return enabled_; }
+		void enable(const bool enabled) noexcept { enabled_ = enabled; }
+		[[nodiscard]] auto pending() const noexcept { return reads.size(); }
+
+		void defer(const std::size_t input, const off_t inputOffset, const off_t outputOffset, const off_t length,
+			byteCounter_t counter = {})
+			{ reads.emplace(input, inputOffset, outputOffset, length, std::move(counter)); }
+		// Takes the next deferred read, waiting for one to be queued if there are none
+		[[nodiscard]] deferredRead_t next() { return reads.pop(); }
+
+		// Tells the slow path workers that the copy is done, one notice per worker
+		void close(const std::size_t workers)
+		{
+			for (std::size_t worker{}; worker < workers; ++worker)
+				reads.emplace();
+		}
+	};
+
+	extern deferredReads_t deferredReads;
+} // namespace pcat
+
+#endif /*DEFERRED_READS__HXX*/
@@ -0,0 +1,152 @@
+#ifndef DEVICE_GROUPS__HXX
+#define DEVICE_GROUPS__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <sys/types.h>
+#ifndef _WINDOWS
+#	include <sys/sysmacros.h>
+#endif
+#include <substrate/fd>
+#include "sysfs.hxx"
+
+using namespace std::literals::string_view_literals;
+
+namespace pcat
+{
+	using substrate::off_t;
+
+	constexpr static auto sysfsRoot{"/sys"sv};
+	// The NUMA node of a device that isn't attached to any one node
+	constexpr static int32_t noNode{-1};
+
+	/*!
+	 * Finds the NUMA node the controller behind a block device is attached to, from sysfs
+	 * under root. A partition has no device link of its own, so for those the whole disk
+	 * one level up is asked instead. Devices without one, such as network file systems
+	 * and tmpfs, give noNode.
+	 */
+	[[nodiscard]] inline int32_t deviceNode(const dev_t device, const std::string_view root = sysfsRoot)
+	{
+#ifndef _WINDOWS
+		const auto path{std::string{root} + "/dev/block/" + std::to_string(major(device)) + ':' +
+			std::to_string(minor(device))};
+		auto node{parseCPUList(readSysfsFile(path + "/device/numa_node"))};
+		if (node.empty())
+			node = parseCPUList(readSysfsFile(path + "/../device/numa_node"));
+		// A single number is just a list of one, and "-1" for no node isn't a valid list so comes out empty
+		return node.size() == 1U ? int32_t(node[0]) : noNode;
+#else
+		static_cast<void>(device);
+		static_cast<void>(root);
+		return noNode;
+#endif
+	}
+
+	struct deviceGroup_t final
+	{
+	private:
+		dev_t device_;
+		std::size_t files_{0};
+		off_t bytes_{0};
+		std::size_t workers_{0};
+		int32_t node_{noNode};
+
+	public:
+		constexpr deviceGroup_t(const dev_t device) noexcept : device_{device} { }
+
+		[[nodiscard]] constexpr auto device() const noexcept { return device_; }
+		[[nodiscard]] constexpr auto files() const noexcept { return files_; }
+		[[nodiscard]] constexpr auto bytes() const noexcept { return bytes_; }
+		[[nodiscard]] constexpr auto workers() const noexcept { return workers_; }
+		constexpr void workers(const std::size_t count) noexcept { workers_ = count; }
+		[[nodiscard]] constexpr auto node() const noexcept { return node_; }
+		constexpr void node(const int32_t node) noexcept { node_ = node; }
+
+		constexpr void addFile(const off_t length) noexcept
+		{
+			++files_;
+			bytes_ += length;
+		}
+	};
+
+	/*!
+	 * Tracks which device each input file lives on so that each device can be given
+	 * its own group of worker threads. Groups are numbered in the order their devices
+	 * are first seen in the inputs.
+	 */
+	struct deviceGroups_t final
+	{
+	private:
+		std::vector<deviceGroup_t> groups{};
+		std::vector<std::size_t> inputGroups{};
+
+	public:
+		void add(const dev_t device, const off_t length)
+		{
+			const auto group
+			{
+				std::find_if(groups.begin(), groups.end(),
+					[device](const deviceGroup_t &group) noexcept { return group.device() == device; })
+			};
+			inputGroups.emplace_back(group - groups.begin());
+			if (group == groups.end())
+				groups.emplace_back(device).addFile(length);
+			else
+				group->addFile(length);
+		}
+
+		// Splits the processors available evenly between the groups unless given a per-group limit
+		void assignWorkers(const std::size_t processors, const std::size_t limit = 0) noexcept
+		{
+			const auto count{groups.size()};
+			for (std::size_t group{}; group < count; ++group)
+			{
+				if (limit)
+					groups[group].workers(limit);
+				else
+					groups[group].workers(std::max<std::size_t>((processors / count) +
+						(group < processors % count ? 1 : 0), 1));
+			}
+		}
+
+		/*!
+		 * Works out which NUMA node each group's device is attached to, so its workers can be
+		 * placed near it. Where an input device isn't attached to a node, the node of the
+		 * device the output lives on is the next best place for the workers copying to it.
+		 */
+		void locate(const dev_t outputDevice, const std::string_view root = sysfsRoot)
+		{
+			const auto outputNode{deviceNode(outputDevice, root)};
+			for (auto &group : groups)
+			{
+				const auto node{deviceNode(group.device(), root)};
+				group.node(node != noNode ? node : outputNode);
+			}
+		}
+
+		// Inputs that weren't gathered with a device (as happens in the tests) all land in the first group
+		[[nodiscard]] std::size_t groupOf(const std::size_t file) const noexcept
+			{ return file < inputGroups.size() ? inputGroups[file] : 0; }
+
+		void clear() noexcept
+		{
+			groups.clear();
+			inputGroups.clear();
+		}
+
+		[[nodiscard]] auto empty() const noexcept { return groups.empty(); }
+		[[nodiscard]] auto size() const noexcept { return groups.size(); }
+		[[nodiscard]] auto begin() const noexcept { return groups.begin(); }
+		[[nodiscard]] auto end() const noexcept { return groups.end(); }
+		[[nodiscard]] const auto &operator [](const std::size_t group) const noexcept { return groups[group]; }
+	};
+
+	extern deviceGroups_t deviceGroups;
+} // namespace pcat
+
+#endif /*DEVICE_GROUPS__HXX*/
@@ -0,0 +1,316 @@
+#ifndef DIRECTORY_WALK__HXX
+#define DIRECTORY_WALK__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <substrate/fd>
+#ifndef _WINDOWS
+#	include <fcntl.h>
+#	include <dirent.h>
+#	include <unistd.h>
+#	include <sys/stat.h>
+#	include <sys/syscall.h>
+#else
+#	include <filesystem>
+#endif
+#include "args.hxx"
+
+using namespace std::literals::string_view_literals;
+
+namespace pcat
+{
+	using substrate::fd_t;
+
+	// Compares names by their runs of digits as numbers and the rest character by character, so rank_9 sorts before rank_10
+	[[nodiscard]] inline bool naturalLess(const std::string_view a, const std::string_view b) noexcept
+	{
+		const auto isDigit{[](const char c) noexcept { return c >= '0' && c <= '9'; }};
+		std::size_t i{};
+		std::size_t j{};
+		while (i < a.size() && j < b.size())
+		{
+			if (isDigit(a[i]) && isDigit(b[j]))
+			{
+				// Skip leading zeros, then the longer run of digits is the larger number
+				while (i < a.size() && a[i] == '0')
+					++i;
+				while (j < b.size() && b[j] == '0')
+					++j;
+				auto endA{i};
+				auto endB{j};
+				while (endA < a.size() && isDigit(a[endA]))
+					++endA;
+				while (endB < b.size() && isDigit(b[endB]))
+					++endB;
+				if (endA - i != endB - j)
+					return endA - i < endB - j;
+				if (const auto result{a.substr(i, endA - i).compare(b.substr(j, endB - j))}; result)
+					return result < 0;
+				i = endA;
+				j = endB;
+			}
+			else if (a[i] != b[j])
+				return static_cast<uint8_t>(a[i]) < static_cast<uint8_t>(b[j]);
+			else
+			{
+				++i;
+				++j;
+			}
+		}
+		if (i < a.size() || j < b.size())
+			return j < b.size();
+		// Names that only differ by leading zeros still need an order, so fall back on comparing them plainly
+		return a < b;
+	}
+
+	/*!
+	 * Walks the directories given as inputs with --recursive, finding the regular files under
+	 * them in a deterministic order: each directory's entries are sorted by name (plainly or
+	 * naturally) and subdirectories are expanded in place, as though the full paths had
+	 * been sorted component by component.
+	 *
+	 * The walk is shared by a set of workers, each taking the next directory waiting to be
+	 * listed, reading it with getdents64() in large batches, sorting it and handing any
+	 * subdirectories back for the next free worker. This keeps several directory reads in
+	 * flight on network file systems where each is a round trip. The entry type from the
+	 * listing is used where the file system gives one, so a file is only stat()ed to find
+	 * out what it is when it doesn't.
+	 */
+	struct directoryWalk_t final
+	{
+	private:
+		constexpr static std::size_t noDirectory{SIZE_MAX};
+#ifndef _WINDOWS
+		constexpr static std::size_t listingLength{65536U};
+#endif
+
+		struct entry_t final
+		{
+			std::string name;
+			// Which directory this entry is, if it's one
+			std::size_t directory{noDirectory};
+		};
+
+		struct directory_t final
+		{
+			std::string path;
+			std::vector<entry_t> entries{};
+
+			directory_t(std::string &&directoryPath) noexcept : path{std::move(directoryPath)} { }
+		};
+
+		args::sort_t order_;
+		// A deque so workers can keep working on a directory while others are added
+		std::deque<directory_t> directories{};
+		std::vector<std::size_t> pending{};
+		std::size_t active{0};
+		int32_t error_{0};
+		std::mutex walkMutex{};
+		std::condition_variable haveWork{};
+
+		[[nodiscard]] std::string pathOf(const directory_t &directory, const std::string_view name) const
+		{
+			std::string path{directory.path};
+			if (path.empty() || path.back() != '/')
+				path += '/';
+			path += name;
+			return path;
+		}
+
+#ifndef _WINDOWS
+		[[nodiscard]] int32_t list(const std::string &path, std::vector<entry_t> &entries) const
+		{
+			const fd_t dir{path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOCTTY};
+			if (!dir.valid())
+				return errno;
+			std::vector<char> listing(listingLength);
+			while (true)
+			{
+				const auto result{syscall(SYS_getdents64, int32_t{dir}, listing.data(), listing.size())};
+				if (result < 0)
+					return errno;
+				else if (!result)
+					break;
+				for (std::size_t offset{}; offset < std::size_t(result);)
+				{
+					// This is laid out as the kernel's linux_dirent64, which glibc's dirent64 matches
+					const auto *const entry{reinterpret_cast<const struct dirent64 *>(listing.data() + offset)}; // NOLINT
+					offset += entry->d_reclen;
+					const std::string_view name{entry->d_name};
+					if (name == "."sv || name == ".."sv)
+						continue;
+					const auto kind{kindOf(dir, entry->d_name, entry->d_type)};
+					// Directories are marked for now, and given their place in the walk once sorted
+					if (kind)
+						entries.push_back({std::string{name}, kind == 2U ? 0U : noDirectory});
+				}
+			}
+			return 0;
+		}
+#else
+		[[nodiscard]] int32_t list(const std::string &path, std::vector<entry_t> &entries) const
+		{
+			std::error_code error{};
+			for (const auto &entry : std::filesystem::directory_iterator{path, error})
+			{
+				if (entry.is_directory(error) && !entry.is_symlink(error))
+					entries.push_back({entry.path().filename().string(), 0U});
+				else if (entry.is_regular_file(error))
+					entries.push_back({entry.path().filename().string()});
+			}
+			return error.value();
+		}
+#endif
+
+		void sort(std::vector<entry_t> &entries) const
+		{
+			if (order_ == args::sort_t::natural)
+				std::sort(entries.begin(), entries.end(), [](const entry_t &a, const entry_t &b) noexcept
+					{ return naturalLess(a.name, b.name); });
+			else
+				std::sort(entries.begin(), entries.end(), [](const entry_t &a, const entry_t &b) noexcept
+					{ return a.name < b.name; });
+		}
+
+		// Waits for a directory to list, giving noDirectory once the walk is over
+		[[nodiscard]] std::size_t nextDirectory()
+		{
+			std::unique_lock<std::mutex> lock{walkMutex};
+			haveWork.wait(lock, [this]() noexcept { return !pending.empty() || !active || error_; });
+			if (pending.empty() || error_)
+				return noDirectory;
+			const auto directory{pending.back()};
+			pending.pop_back();
+			++active;
+			return directory;
+		}
+
+		void listDirectory(const std::size_t index)
+		{
+			std::vector<entry_t> entries{};
+			std::string path{};
+			{
+				std::lock_guard<std::mutex> lock{walkMutex};
+				path = directories[index].path;
+			}
+			const auto result{list(path, entries)};
+			if (!result)
+				sort(entries);
+
+			std::lock_guard<std::mutex> lock{walkMutex};
+			--active;
+			if (result)
+				error_ = result;
+			else
+			{
+				for (auto &entry : entries)
+				{
+					if (entry.directory == noDirectory)
+						continue;
+					entry.directory = directories.size();
+					directories.emplace_back(pathOf(directories[index], entry.name));
+					pending.emplace_back(entry.directory);
+				}
+				directories[index].entries = std::move(entries);
+			}
+			haveWork.notify_all();
+		}
+
+		void flatten(const std::size_t index, std::vector<std::string> &files) const
+		{
+			const auto &directory{directories[index]};
+			for (const auto &entry : directory.entries)
+			{
+				if (entry.directory == noDirectory)
+					files.emplace_back(pathOf(directory, entry.name));
+				else
+					flatten(entry.directory, files);
+			}
+		}
+
+	public:
+		directoryWalk_t(const std::string_view root, const args::sort_t order) : order_{order}
+		{
+			directories.emplace_back(std::string{root});
+			pending.emplace_back(0U);
+		}
+
+		directoryWalk_t(const directoryWalk_t &) = delete;
+		directoryWalk_t(directoryWalk_t &&) = delete;
+		~directoryWalk_t() noexcept = default;
+		directoryWalk_t &operator =(const directoryWalk_t &) = delete;
+		directoryWalk_t &operator =(directoryWalk_t &&) = delete;
+
+#ifndef _WINDOWS
+		/*!
+		 * Works out if an entry is a regular file (1), directory (2) or neither (0) from the type
+		 * the listing gave for it, asking the file system when it gave none. Links to regular files
+		 * count as files, while links to directories are left alone so a loop can't trap the walk.
+		 */
+		[[nodiscard]] static uint8_t kindOf(const int32_t dir, const char *const name, const uint8_t type) noexcept
+		{
+			if (type == DT_REG)
+				return 1U;
+			else if (type == DT_DIR)
+				return 2U;
+			else if (type != DT_UNKNOWN && type != DT_LNK)
+				return 0U;
+			struct stat entryStat{};
+			// Without a type from the listing, find out if the entry is a link before following it
+			if (type == DT_UNKNOWN)
+			{
+				if (fstatat(dir, name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0)
+					return 0U;
+				else if (!S_ISLNK(entryStat.st_mode))
+					return S_ISREG(entryStat.st_mode) ? 1U : S_ISDIR(entryStat.st_mode) ? 2U : 0U;
+			}
+			if (fstatat(dir, name, &entryStat, 0) != 0)
+				return 0U;
+			return S_ISREG(entryStat.st_mode) ? 1U : 0U;
+		}
+#endif
+
+		// Takes part in the walk, returning once there are no directories left to list
+		int32_t run()
+		{
+			for (auto directory{nextDirectory()}; directory != noDirectory; directory = nextDirectory())
+				listDirectory(directory);
+			return error_;
+		}
+
+		[[nodiscard]] bool valid() const noexcept { return !error_; }
+		[[nodiscard]] auto error() const noexcept { return error_; }
+		[[nodiscard]] auto directoryCount() const noexcept { return directories.size(); }
+
+		// Gives the files found by the walk in order, once it's done
+		[[nodiscard]] std::vector<std::string> files() const
+		{
+			std::vector<std::string> result{};
+			flatten(0U, result);
+			return result;
+		}
+	};
+
+	[[nodiscard]] inline bool isDirectory(const char *const path) noexcept
+	{
+#ifndef _WINDOWS
+		struct stat pathStat{};
+		return stat(path, &pathStat) == 0 && S_ISDIR(pathStat.st_mode);
+#else
+		std::error_code error{};
+		return std::filesystem::is_directory(path, error);
+#endif
+	}
+
+	inline int32_t walkDirectories(directoryWalk_t *const walk) { return walk->run(); }
+} // namespace pcat
+
+#endif /*DIRECTORY_WALK__HXX*/
@@ -0,0 +1,120 @@
+#ifndef FILE_LIST__HXX
+#define FILE_LIST__HXX
+
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <substrate/fd>
+#include "mmap.hxx"
+
+namespace pcat
+{
+	using substrate::fd_t;
+	using substrate::off_t;
+
+	/*!
+	 * Reads the list of inputs given with --files-from, one path per entry. Entries are
+	 * separated by NULs if the list contains any (as from find -print0), and by newlines
+	 * otherwise, with empty entries skipped.
+	 *
+	 * Where the list is a regular file it is mapped read-only and every entry is a view
+	 * straight into the mapping, so nothing of the list is copied. The entries aren't NUL
+	 * terminated, so whatever opens them has to make its own terminated copy of each path.
+	 * Lists on a pipe, such as from stdin, are read in to a buffer first and split the same way.
+	 */
+	struct fileList_t final
+	{
+	private:
+		constexpr static std::size_t readLength{65536U};
+
+		std::optional<mmap_t> mapping{};
+		std::vector<char> buffer{};
+		std::vector<std::string_view> entries_{};
+		int32_t error_{0};
+
+		[[nodiscard]] bool readAll(const fd_t &file)
+		{
+			std::size_t length{};
+			while (true)
+			{
+				buffer.resize(length + readLength);
+				const auto result{read(file, buffer.data() + length, readLength)};
+				if (result < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					return false;
+				}
+				else if (!result)
+					break;
+				length += std::size_t(result);
+			}
+			buffer.resize(length);
+			return true;
+		}
+
+		void split(const char *const begin, const std::size_t length)
+		{
+			const char separator{std::memchr(begin, '\0', length) ? '\0' : '\n'};
+			const auto *const end{begin + length};
+			for (const auto *entry{begin}; entry < end;)
+			{
+				const auto *next{static_cast<const char *>(std::memchr(entry, separator, std::size_t(end - entry)))};
+				// The list needn't end with a separator, in which case the last entry runs to its end
+				if (!next)
+					next = end;
+				if (next != entry)
+					entries_.emplace_back(entry, std::size_t(next - entry));
+				entry = next + 1;
+			}
+		}
+
+	public:
+		fileList_t(const std::string_view path)
+		{
+			// "-" means to read the list from stdin, which we dup so the list can be closed like any other
+			fd_t file{path == "-" ? fd_t{dup(0)} : fd_t{path.data(), O_RDONLY | O_NOCTTY}};
+			if (!file.valid())
+			{
+				error_ = errno;
+				return;
+			}
+
+			const auto length{file.length()};
+#ifndef _WINDOWS
+			if (length > 0)
+			{
+				mapping.emplace(file, length, PROT_READ);
+				if (mapping->valid())
+				{
+					split(static_cast<const char *>(mapping->address(0)), std::size_t(length));
+					return;
+				}
+				// Not everything that reports a length can be mapped, so fall back to reading it
+				mapping.reset();
+			}
+#endif
+			if (!readAll(file))
+			{
+				error_ = errno;
+				return;
+			}
+			split(buffer.data(), buffer.size());
+		}
+
+		fileList_t(const fileList_t &) = delete;
+		fileList_t(fileList_t &&) = delete;
+		~fileList_t() noexcept = default;
+		fileList_t &operator =(const fileList_t &) = delete;
+		fileList_t &operator =(fileList_t &&) = delete;
+
+		[[nodiscard]] bool valid() const noexcept { return !error_; }
+		[[nodiscard]] auto error() const noexcept { return error_; }
+		[[nodiscard]] const auto &entries() const noexcept { return entries_; }
+	};
+} // namespace pcat
+
+#endif /*FILE_LIST__HXX*/
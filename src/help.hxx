@@ -18,19 +18,103 @@ Options:
 
 	-o, --output    Specifies the file to write the concatinated output to
 	                this file may NOT be stdout and must be on a mmap-able file system.
+	--files-from    Reads input files from the given list, one per line, or separated by
+	                NULs if the list contains any. A list of '-' is read from stdin.
+	                The inputs listed are concatenated in where the option is given,
+	                allowing more inputs than will fit on the command line.
+	-r, --recursive Allows directories to be given as inputs, in which case every regular
+	                file under them is concatenated, in sorted order. Subdirectories are
+	                walked in parallel.
+	--sort          Selects how the files found in directories are ordered.
+	                'lexical' (default) sorts them by name, byte by byte.
+	                'natural' sorts runs of digits in names by their value, so that
+	                rank_9 comes before rank_10.
 
 	-t, --threads   If specified, this gives a thread count cap for the program to use
 	                so long as the number is less than the number of logical cores present.
+	                When not given on Linux, the thread count is capped by the CPU quota
+	                (cpu.max) of the cgroup pcat runs in, and only the CPUs in the cgroup's
+	                cpuset are used.
+	                Given 'auto', pcat starts with a few copy threads and adds or parks
+	                them as the copy runs, settling on however many give the best
+	                throughput, up to the number it would otherwise use.
 	-c, --core-pins Specifies which cores to pin the copy threads to.
 	                When specified, this option must have the same number of cores specified
 	                as threads given with -t/--threads. The same effect can be acomplished
 	                using numactl, but this is provided for convenience and flexibility.
+	--placement     Selects which CPUs the copy threads are placed on, on Linux.
+	                'cores' (default) places one thread on each physical core, only
+	                using a core's other hardware threads once every core has one.
+	                'threads' uses every hardware thread, in CPU number order.
+	                'compact' uses every hardware thread, filling each core and then
+	                each socket before moving on to the next.
+	                'scatter' uses every hardware thread, spreading them across the
+	                sockets and then the cores of each before doubling up on any core.
+	                This is ignored when -c/--core-pins is given.
+	--device-threads
+	                Inputs are grouped by the device they live on, with each device given its
+	                own group of threads so a slow device cannot starve a fast one of work.
+	                By default the threads available are split evenly between the devices,
+	                this option instead caps how many threads each device's group may use.
 	--algorithm     Selects between block chunking algorithms as different storage configurations
 	                react differently to different access patterns.
 	                'blockLinear' (default) configures pcat to chunk the inputs up in a linear
 	                manner, queueing them as it does for consumption by the worker threads.
 	                'chunkSpans' configures pcat to chunk the file up into threads equal amounts
 	                and have each thread linearly work through a unique chunk of the file.
+	                'pipeline' configures pcat to split each copy between reader threads that
+	                fill buffers from the inputs and writer threads that drain them to the
+	                output, so the latency of the inputs and output overlap. This is of most
+	                use when the inputs and output live on different storage systems.
+	                'auto' has pcat pick for itself from the number and sizes of the inputs,
+	                the filesystems they and the output are on (such as Lustre, GPFS, NFS,
+	                tmpfs or XFS), and whether they share a device. It also picks the engine,
+	                schedule, block size and thread count to go with it, though any of these
+	                given on the command line are kept. Use --verbose to see what was picked.
+	--schedule      Selects how the 'chunkSpans' algorithm hands out spans to threads.
+	                'static' (default) cuts the output into one equal span per thread up front.
+	                'guided' hands out spans that start large and shrink toward the transfer
+	                block size as the copy nears its end, with idle threads splitting the
+	                remaining work of any thread that is still busy.
+	--engine        Selects how the 'blockLinear' and 'chunkSpans' algorithms read the inputs.
+	                'mmap' (default) maps each input, reading small ones with pread().
+	                'nowait' reads whatever of each input is already in the page cache
+	                straight away, deferring the rest to a larger set of threads that wait
+	                on storage, so cold data doesn't hold up the copying of hot data.
+	                On Windows, where this isn't possible, 'nowait' falls back on 'mmap'.
+	--cached-first  Has the 'blockLinear' and static 'chunkSpans' algorithms check which
+	                parts of the inputs are already in the page cache before copying, and
+	                copy those first while the rest is read ahead, rather than strictly in
+	                order. This helps when an earlier step has left some inputs cached.
+	--physical-order
+	                Has the 'blockLinear' and static 'chunkSpans' algorithms ask where each
+	                input lies on its device (with FIEMAP), and copy in that order on each
+	                device rather than in the order of the output, so fragmented inputs on
+	                spinning disks or tape-staged storage are read in one sweep rather than
+	                seeking back and forth. Each block is still written to its own place in
+	                the output. With --cached-first, cached parts still go first.
+	--block-size    Sets the size of the blocks the output is copied in, in bytes or with a
+	                k, m or g suffix, as a multiple of 4KiB up to 64MiB. The default is 1MiB.
+	                Given 'auto', pcat starts from the preferred IO size of the storage,
+	                which on Lustre and GPFS is the stripe or filesystem block size, and
+	                grows or shrinks the blocks as the copy runs depending on how long each
+	                takes, so blocks are big enough to be worth setting up but small enough
+	                to keep the end of the copy balanced between threads.
+	--stripe-size   Lines blocks up with the stripes of the output on Lustre or GPFS, so no
+	                block is split between two storage targets, and makes each block one
+	                stripe, or enough to make 1MiB, unless --block-size is also given. Takes
+	                a size as for --block-size, or 'auto' to ask Lustre, falling back on the
+	                output's preferred IO size, which on GPFS is the filesystem block size.
+	--stripe-count  Sets how many storage targets the output's stripes go round-robin over,
+	                so threads working side by side start out on different targets. Found
+	                out from Lustre when not given. Either option turns stripe alignment on.
+	--readers       Sets how many threads the 'pipeline' algorithm uses to read the inputs.
+	--writers       Sets how many threads the 'pipeline' algorithm uses to write the output.
+	                By default the threads available are split evenly between the two.
+	--max-open      Caps how many inputs are held open at once. Inputs are then opened just
+	                before their first block is copied and closed after their last, rather
+	                than all being opened and locked up front. This is done automatically
+	                when there are more inputs than the open file limit would allow.
 
 	--async         Specifies to omit issuing msync() on each completed block, thereby
 	                putting the program into asynchronous operation.
@@ -51,6 +135,11 @@ Options:
 	                of a successfully completed concatenation.
 	--no-sync       Synonym for --async
 
+	--stats         Print statistics about the copy, including how the inputs were grouped
+	                by device, once it completes.
+	-v, --verbose   Print how the copy was set up, such as which CPUs the threads were
+	                placed on, before it starts.
+
 This utility is licensed under the GPLv3+
 Report bugs using https://github.com/DX-MON/pcat/issues)"sv
 	};
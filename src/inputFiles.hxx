@@ -0,0 +1,283 @@
+#ifndef INPUT_FILES__HXX
+#define INPUT_FILES__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sys/types.h>
+#ifndef _WINDOWS
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#	include <sys/sysmacros.h>
+#endif
+#include <substrate/fd>
+
+namespace pcat
+{
+	using substrate::fd_t;
+	using substrate::off_t;
+
+	// The metadata for an input, gathered with a single stat call
+	struct inputMetadata_t final
+	{
+		off_t length{};
+		dev_t device{};
+		// The preferred IO size for the input
+		std::size_t blockSize{};
+		// The alignment required of offsets for direct IO on the input, or 0 if unknown
+		std::size_t alignment{};
+		bool sparse{false};
+
+#ifndef _WINDOWS
+	private:
+		// Gathers the metadata for the path relative to dir with plain stat(), which can't find out the DIO alignment
+		[[nodiscard]] static inputMetadata_t ofStat(const int32_t dir, const char *const path) noexcept
+		{
+			struct stat fileStat{};
+			if ((*path ? fstatat(dir, path, &fileStat, 0) : fstat(dir, &fileStat)) != 0)
+				return {};
+			return
+			{
+				fileStat.st_size, fileStat.st_dev, std::size_t(fileStat.st_blksize), 0U,
+				// NOLINTNEXTLINE(readability-magic-numbers)
+				(fileStat.st_blocks * 512) < fileStat.st_size
+			};
+		}
+
+		// Gathers the metadata for the path relative to dir, with an empty path meaning dir itself
+		[[nodiscard]] static inputMetadata_t of(const int32_t dir, const char *const path) noexcept
+		{
+#ifdef STATX_DIOALIGN
+			struct statx fileStat{};
+			if (statx(dir, path, *path ? 0 : AT_EMPTY_PATH, STATX_BASIC_STATS | STATX_DIOALIGN, &fileStat) != 0)
+			{
+				// Old kernels don't have statx(), and seccomp filters (as in some containers) may refuse it
+				if (errno == ENOSYS || errno == EPERM)
+					return ofStat(dir, path);
+				return {};
+			}
+			return
+			{
+				off_t(fileStat.stx_size), makedev(fileStat.stx_dev_major, fileStat.stx_dev_minor),
+				fileStat.stx_blksize, fileStat.stx_dio_offset_align,
+				// NOLINTNEXTLINE(readability-magic-numbers)
+				(fileStat.stx_blocks * 512U) < fileStat.stx_size
+			};
+#else
+			return ofStat(dir, path);
+#endif
+		}
+
+	public:
+		[[nodiscard]] static inputMetadata_t of(const fd_t &file) noexcept { return of(file, ""); }
+		[[nodiscard]] static inputMetadata_t of(const char *const path) noexcept { return of(AT_FDCWD, path); }
+#else
+		[[nodiscard]] static inputMetadata_t of(const fd_t &file) noexcept { return {file.length()}; }
+		[[nodiscard]] static inputMetadata_t of(const char *const path) noexcept
+		{
+			const fd_t file{path, O_RDONLY};
+			return file.valid() ? of(file) : inputMetadata_t{};
+		}
+#endif
+	};
+
+	// An input opened for copying some of it, which is closed again afterwards if it was only opened for that
+	struct openInput_t final
+	{
+	private:
+		fd_t transient_{};
+		const fd_t *file_;
+
+	public:
+		openInput_t(const fd_t &file) noexcept : file_{&file} { }
+		openInput_t(fd_t &&file) noexcept : transient_{std::move(file)}, file_{&transient_} { }
+		openInput_t(const openInput_t &) = delete;
+		openInput_t(openInput_t &&) = delete;
+		~openInput_t() noexcept = default;
+		openInput_t &operator =(const openInput_t &) = delete;
+		openInput_t &operator =(openInput_t &&) = delete;
+
+		[[nodiscard]] bool valid() const noexcept { return file_->valid(); }
+		[[nodiscard]] bool transient() const noexcept { return file_ == &transient_; }
+		[[nodiscard]] const fd_t &operator *() const noexcept { return *file_; }
+	};
+
+	/*!
+	 * Holds the input files as a table of their metadata, stored column-wise and gathered
+	 * once as each input is added, so the chunkers only ever read plain integers rather than
+	 * asking the OS (which, on Lustre, means a metadata RPC) about an input again.
+	 *
+	 * Alongside this, a prefix sum of the input lengths is built up so that any offset into
+	 * the output can be mapped back to the input it comes from, and where in that input,
+	 * with a binary search rather than by walking the inputs one at a time.
+	 *
+	 * When there are more inputs than can be held open at once, the table can be put into
+	 * lazy mode. Inputs are then added by path, opened when their first chunk is copied and
+	 * closed once the last of their bytes has been, with at most a budget's worth held open
+	 * at any one time. Past that budget, an input is opened only for the chunk being copied.
+	 */
+	struct inputFiles_t final
+	{
+	private:
+		std::vector<fd_t> files{};
+		// offsets[n] is where input n begins in the output, with the extra last entry being the total length
+		std::vector<off_t> offsets{0};
+		std::vector<dev_t> devices{};
+		std::vector<std::size_t> blockSizes{};
+		std::vector<std::size_t> alignments{};
+		std::vector<bool> sparse{};
+		std::vector<std::string> paths{};
+		// The number of bytes of each input still to be copied, used to know when to close lazily opened inputs
+		std::vector<off_t> remaining{};
+		std::size_t openBudget{0};
+		std::atomic<std::size_t> openCount{0};
+		// Lazily opened inputs are guarded by one of a set of locks picked by index, rather than one lock each
+		std::array<std::mutex, 64> openLocks{};
+
+		[[nodiscard]] std::mutex &openLock(const std::size_t index) noexcept
+			{ return openLocks[index % openLocks.size()]; }
+
+	public:
+		using iterator = typename std::vector<fd_t>::iterator;
+		using const_iterator = typename std::vector<fd_t>::const_iterator;
+
+		inputFiles_t() = default;
+		inputFiles_t(const inputFiles_t &) = delete;
+		inputFiles_t(inputFiles_t &&) = delete;
+		~inputFiles_t() noexcept = default;
+		inputFiles_t &operator =(const inputFiles_t &) = delete;
+		inputFiles_t &operator =(inputFiles_t &&) = delete;
+
+		fd_t &emplace_back(fd_t &&file) { return emplace_back(std::move(file), inputMetadata_t::of(file)); }
+
+		fd_t &emplace_back(fd_t &&file, const inputMetadata_t &metadata)
+		{
+			// Reserve up front so an allocation failure can't leave the columns out of step
+			offsets.reserve(offsets.size() + 1U);
+			devices.reserve(devices.size() + 1U);
+			blockSizes.reserve(blockSizes.size() + 1U);
+			alignments.reserve(alignments.size() + 1U);
+			sparse.reserve(sparse.size() + 1U);
+			paths.reserve(paths.size() + 1U);
+			remaining.reserve(remaining.size() + 1U);
+			auto &result{files.emplace_back(std::move(file))};
+			offsets.emplace_back(offsets.back() + metadata.length);
+			devices.emplace_back(metadata.device);
+			blockSizes.emplace_back(metadata.blockSize);
+			alignments.emplace_back(metadata.alignment);
+			sparse.emplace_back(metadata.sparse);
+			paths.emplace_back();
+			remaining.emplace_back(metadata.length);
+			return result;
+		}
+
+		// Adds an input that is to be opened lazily by path when it is first copied from
+		void emplace_back(const std::string_view path, const inputMetadata_t &metadata)
+		{
+			emplace_back(fd_t{}, metadata);
+			paths.back() = path;
+		}
+
+		void clear() noexcept
+		{
+			files.clear();
+			offsets.erase(offsets.begin() + 1, offsets.end());
+			devices.clear();
+			blockSizes.clear();
+			alignments.clear();
+			sparse.clear();
+			paths.clear();
+			remaining.clear();
+			openBudget = 0;
+			openCount = 0;
+		}
+
+		[[nodiscard]] auto size() const noexcept { return files.size(); }
+		[[nodiscard]] auto empty() const noexcept { return files.empty(); }
+		[[nodiscard]] auto begin() noexcept { return files.begin(); }
+		[[nodiscard]] auto begin() const noexcept { return files.begin(); }
+		[[nodiscard]] auto end() noexcept { return files.end(); }
+		[[nodiscard]] auto end() const noexcept { return files.end(); }
+		[[nodiscard]] fd_t &operator [](const std::size_t index) noexcept { return files[index]; }
+		[[nodiscard]] const fd_t &operator [](const std::size_t index) const noexcept { return files[index]; }
+
+		[[nodiscard]] off_t totalLength() const noexcept { return offsets.back(); }
+		[[nodiscard]] off_t offsetOf(const std::size_t index) const noexcept
+			{ return offsets[std::min(index, files.size())]; }
+		[[nodiscard]] off_t offsetOf(const const_iterator &file) const noexcept
+			{ return offsetOf(std::size_t(file - files.begin())); }
+		[[nodiscard]] off_t lengthOf(const std::size_t index) const noexcept
+			{ return index < files.size() ? offsets[index + 1] - offsets[index] : 0; }
+		[[nodiscard]] off_t lengthOf(const const_iterator &file) const noexcept
+			{ return lengthOf(std::size_t(file - files.begin())); }
+		[[nodiscard]] dev_t deviceOf(const std::size_t index) const noexcept { return devices[index]; }
+		[[nodiscard]] std::size_t blockSizeOf(const std::size_t index) const noexcept { return blockSizes[index]; }
+		[[nodiscard]] std::size_t alignmentOf(const std::size_t index) const noexcept { return alignments[index]; }
+		[[nodiscard]] bool sparseAt(const std::size_t index) const noexcept { return sparse[index]; }
+		// Gets the path of an input added in lazy mode, which is empty for those opened up front
+		[[nodiscard]] const std::string &pathOf(const std::size_t index) const noexcept { return paths[index]; }
+		[[nodiscard]] std::size_t indexOf(const const_iterator &file) const noexcept
+			{ return std::size_t(file - files.begin()); }
+
+		// Puts the table into lazy mode, holding at most budget inputs open at once
+		void lazy(const std::size_t budget) noexcept { openBudget = budget; }
+		[[nodiscard]] bool lazy() const noexcept { return openBudget; }
+		[[nodiscard]] std::size_t openFiles() const noexcept { return openCount; }
+
+		// Gets the input ready to be copied from, opening it first in lazy mode
+		[[nodiscard]] openInput_t acquire(const std::size_t index)
+		{
+			if (!openBudget)
+				return openInput_t{files[index]};
+			std::lock_guard<std::mutex> lock{openLock(index)};
+			auto &file{files[index]};
+			if (file.valid() || !remaining[index])
+				return openInput_t{file};
+			// The budget is soft - once it's used up, open the input just for this chunk rather than wait
+			if (openCount++ >= openBudget)
+			{
+				--openCount;
+				return openInput_t{fd_t{paths[index].c_str(), O_RDONLY | O_NOCTTY}};
+			}
+			file = fd_t{paths[index].c_str(), O_RDONLY | O_NOCTTY};
+			if (!file.valid())
+				--openCount;
+			return openInput_t{file};
+		}
+
+		// Marks bytes of the input as copied, closing it in lazy mode once all of it has been
+		void release(const std::size_t index, const off_t bytes)
+		{
+			if (!openBudget)
+				return;
+			std::lock_guard<std::mutex> lock{openLock(index)};
+			remaining[index] -= bytes;
+			if (remaining[index] <= 0 && files[index].valid())
+			{
+				files[index] = fd_t{};
+				--openCount;
+			}
+		}
+
+		// Finds the input a given offset into the output lands in, and where in that input, giving end() past the end
+		[[nodiscard]] std::pair<iterator, off_t> locate(const off_t offset) noexcept
+		{
+			// The first input to end after the offset is the one that holds it
+			const auto next{std::upper_bound(offsets.begin() + 1, offsets.end(), offset)};
+			const auto index{std::size_t(next - offsets.begin()) - 1U};
+			if (index >= files.size())
+				return {files.end(), 0};
+			return {files.begin() + index, offset - offsets[index]};
+		}
+	};
+} // namespace pcat
+
+#endif /*INPUT_FILES__HXX*/
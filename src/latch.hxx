@@ -4,7 +4,6 @@
 #include <cstddef>
 #include <mutex>
 #include <condition_variable>
-#include <atomic>
 
 namespace pcat
 {
@@ -13,23 +12,29 @@ namespace pcat
 	private:
 		mutable std::mutex latchMutex{};
 		mutable std::condition_variable waitZero{};
-		std::atomic<std::size_t> count{};
+		std::size_t count;
 
 	public:
-		explicit latch_t(std::size_t expected) : count{expected} { }
+		explicit latch_t(const std::size_t expected) noexcept : count{expected} { }
 		~latch_t() = default;
 
-		void countDown() noexcept { if (count) --count; }
+		void countDown() noexcept
+		{
+			std::lock_guard<std::mutex> lock{latchMutex};
+			if (count && !--count)
+				waitZero.notify_all();
+		}
+
+		[[nodiscard]] bool tryWait() const noexcept
+		{
+			std::lock_guard<std::mutex> lock{latchMutex};
+			return !count;
+		}
 
 		void wait() const noexcept
 		{
-			if (!count)
-				waitZero.notify_all();
-			else
-			{
-				std::unique_lock<std::mutex> lock{latchMutex};
-				waitZero.wait(lock, [this]() noexcept -> bool { return !count; });
-			}
+			std::unique_lock<std::mutex> lock{latchMutex};
+			waitZero.wait(lock, [this]() noexcept -> bool { return !count; });
 		}
 
 		void arriveAndWait() noexcept
@@ -1,57 +1,248 @@
 #ifndef AFFINITY__HXX
 #define AFFINITY__HXX
 
+#include <cstddef>
+#include <cerrno>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <thread>
 #include <algorithm>
 #include <system_error>
 #include <stdexcept>
+#include <new>
 #include <sched.h>
 #include "args.hxx"
 #include "indexSequence.hxx"
+#include "processorPlacement.hxx"
+#include "cgroupLimits.hxx"
 
 namespace pcat
 {
+	// Where the set of CPUs we're allowed to run on comes from, which has the signature of sched_getaffinity()
+	using affinitySource_t = int (*)(pid_t, std::size_t, cpu_set_t *);
+
+	// A CPU set sized at runtime, as a cpu_set_t only holds CPU_SETSIZE (1024) CPUs
+	struct cpuSet_t final
+	{
+	private:
+		std::size_t count_;
+		cpu_set_t *set_;
+
+	public:
+		cpuSet_t(const std::size_t count) : count_{count}, set_{CPU_ALLOC(count)}
+		{
+			if (!set_)
+				throw std::bad_alloc{};
+			CPU_ZERO_S(size(), set_);
+		}
+
+		cpuSet_t(const cpuSet_t &) = delete;
+		cpuSet_t(cpuSet_t &&) = delete;
+		~cpuSet_t() noexcept { CPU_FREE(set_); }
+		cpuSet_t &operator =(const cpuSet_t &) = delete;
+		cpuSet_t &operator =(cpuSet_t &&) = delete;
+
+		[[nodiscard]] auto count() const noexcept { return count_; }
+		[[nodiscard]] std::size_t size() const noexcept { return CPU_ALLOC_SIZE(count_); }
+		[[nodiscard]] cpu_set_t *get() const noexcept { return set_; }
+		[[nodiscard]] bool isSet(const std::size_t cpu) const noexcept { return CPU_ISSET_S(cpu, size(), set_); }
+		void set(const std::size_t cpu) noexcept { CPU_SET_S(cpu, size(), set_); }
+	};
+
+	// What affinity_t needs to know of the machine, which for the one we're running on is read once and kept
+	struct processorInventory_t final
+	{
+		// The CPUs we're allowed to run on, in CPU number order, and where each of them sits in the machine
+		std::vector<uint32_t> allowed{};
+		std::vector<processorTopology_t> topology{};
+		// The limits of the cgroup we're in, as walking the cgroup tree for them is as costly as the topology
+		cgroupLimits_t cgroup;
+	};
+
 	struct affinity_t final
 	{
 	private:
+		// The largest CPU set we'll try before deciding the affinity source is never going to be happy
+		constexpr static std::size_t maxProcessors{1U << 20U};
 		std::vector<uint32_t> processors{};
+		// Where the set of processors and the number of them used came from, for --verbose
+		std::string_view setSource_{};
+		std::string_view countSource_{};
 
 		void pinTo(const pthread_t thread, const std::size_t index) const
 		{
 			if (index >= processors.size())
 				throw std::out_of_range{"index into thread affinity object too large"};
-			cpu_set_t affinity{};
-			CPU_SET(processors[index], &affinity);
-			pthread_setaffinity_np(thread, sizeof(cpu_set_t), &affinity);
+			cpuSet_t affinity{processors[index] + 1U};
+			affinity.set(processors[index]);
+			pthread_setaffinity_np(thread, affinity.size(), affinity.get());
 		}
 
-	public:
-		affinity_t()
+		// Works out how many CPUs the kernel could ever bring up, from the highest numbered in the possible list
+		[[nodiscard]] static std::size_t possibleProcessors(const std::string_view topologyRoot)
+		{
+			const auto possible{parseCPUList(readSysfsFile(std::string{topologyRoot} + "/possible"))};
+			if (possible.empty())
+				return CPU_SETSIZE;
+			return std::max<std::size_t>(*std::max_element(possible.begin(), possible.end()) + 1U, CPU_SETSIZE);
+		}
+
+		/*!
+		 * Gets the CPUs we're allowed to run on, in CPU number order. The set asked for starts
+		 * out sized by the kernel's possible CPUs, and if the kernel says that's too small
+		 * (as it does when its own idea of the largest CPU set is bigger) it is doubled until
+		 * it fits.
+		 */
+		[[nodiscard]] static std::vector<uint32_t> allowedProcessors(const affinitySource_t affinitySource,
+			const std::string_view topologyRoot)
+		{
+			for (auto count{possibleProcessors(topologyRoot)}; count <= maxProcessors; count *= 2U)
+			{
+				cpuSet_t affinity{count};
+				if (affinitySource(0, affinity.size(), affinity.get()) != 0)
+				{
+					if (errno == EINVAL)
+						continue;
+					throw std::system_error{errno, std::system_category()};
+				}
+				std::vector<uint32_t> allowed{};
+				// The set may have been rounded up in size, so check every CPU it has room for
+				const auto processors{affinity.size() * 8U};
+				for (std::size_t cpu{}; cpu < processors; ++cpu)
+				{
+					if (affinity.isSet(cpu))
+						allowed.push_back(uint32_t(cpu));
+				}
+				return allowed;
+			}
+			throw std::system_error{EINVAL, std::system_category()};
+		}
+
+		// Reads the machine we're running on the first time it's asked after, so building each affinity is cheap
+		[[nodiscard]] static const processorInventory_t &systemInventory()
+		{
+			static const processorInventory_t inventory{inventoryOf(cpuTopologyRoot, sched_getaffinity, {})};
+			return inventory;
+		}
+
+		[[nodiscard]] static processorInventory_t inventoryOf(const std::string_view topologyRoot,
+			const affinitySource_t affinitySource, const cgroupLimits_t &cgroup)
+		{
+			auto allowed{allowedProcessors(affinitySource, topologyRoot)};
+			auto topology{readProcessorTopology(allowed, topologyRoot)};
+			return {std::move(allowed), std::move(topology), cgroup};
+		}
+
+		/*!
+		 * Builds the affinity for the copy threads from what's known of the machine. Unless told
+		 * otherwise with --threads, the number of threads is capped by the CPU quota of the
+		 * cgroup we're in, as sched_getaffinity() happily reports every CPU in the machine when
+		 * the cgroup only gives us a few CPUs' worth of time on them.
+		 */
+		affinity_t(const processorInventory_t &inventory)
 		{
 			const auto *const pinning{dynamic_cast<args::argPinning_t *>(::args->find(argType_t::pinning))};
 			const auto *const threadCount{dynamic_cast<args::argThreads_t *>(::args->find(argType_t::threads))};
-			cpu_set_t affinity{};
-			if (sched_getaffinity(0, sizeof(cpu_set_t), &affinity) != 0)
-				throw std::system_error{errno, std::system_category()};
-			for (uint32_t i{0}; i < CPU_SETSIZE; ++i)
+			const auto *const placement{dynamic_cast<args::argPlacement_t *>(::args->find(argType_t::placement))};
+			const auto &cgroup{inventory.cgroup};
+			auto allowed{inventory.allowed};
+			setSource_ = "the affinity mask"sv;
+			const auto &cpuset{cgroup.cpuset()};
+			const auto keep{[&](const auto &processors)
+			{
+				allowed.erase(std::remove_if(allowed.begin(), allowed.end(), [&](const uint32_t processor)
+					{ return std::find(processors.begin(), processors.end(), processor) == processors.end(); }),
+					allowed.end());
+			}};
+			if (!cpuset.empty() && std::any_of(allowed.begin(), allowed.end(), [&](const uint32_t processor)
+				{ return std::find(cpuset.begin(), cpuset.end(), processor) == cpuset.end(); }))
+			{
+				keep(cpuset);
+				setSource_ = "the cgroup's cpuset"sv;
+			}
+			if (pinning)
+			{
+				keep(*pinning);
+				setSource_ = "--core-pins"sv;
+			}
+
+			const std::size_t limit{threadCount ? threadCount->threads() : 0U};
+			// Cores given by the user are used as given, in order, rather than being placed
+			if (pinning)
+			{
+				processors = std::move(allowed);
+				if (limit && processors.size() > limit)
+					processors.resize(limit);
+			}
+			else
 			{
-				if (CPU_ISSET(i, &affinity))
+				// Both are in CPU number order, so the topology of what's left is found by a merge
+				std::vector<processorTopology_t> topology{};
+				topology.reserve(allowed.size());
+				auto processor{allowed.begin()};
+				for (const auto &entry : inventory.topology)
 				{
-					if ((!threadCount || processors.size() < threadCount->threads()) &&
-						(!pinning || std::find(pinning->begin(), pinning->end(), i) != pinning->end()))
-						processors.push_back(i);
-					CPU_CLR(i, &affinity);
+					while (processor != allowed.end() && *processor < entry.cpu)
+						++processor;
+					if (processor != allowed.end() && *processor == entry.cpu)
+						topology.push_back(entry);
 				}
-				else if (!CPU_COUNT(&affinity))
-					break;
+				const auto order{placement ? placement->placement() : args::placement_t::cores};
+				processors = placeProcessors(std::move(topology), order, limit);
+				countSource_ = order == args::placement_t::cores ? "one thread per physical core"sv :
+					"every allowed CPU"sv;
+			}
+
+			if (limit)
+				countSource_ = "--threads"sv;
+			else if (cgroup.cpuQuota() && cgroup.cpuQuota() < processors.size())
+			{
+				processors.resize(cgroup.cpuQuota());
+				countSource_ = "the cgroup's CPU quota"sv;
 			}
+			else if (pinning)
+				countSource_ = "--core-pins"sv;
+		}
+
+	public:
+		affinity_t() : affinity_t{systemInventory()} { }
+
+		/*!
+		 * Builds the affinity for the copy threads, reading the processor topology from under
+		 * topologyRoot and the CPUs we may run on from affinitySource, which is normally
+		 * sched_getaffinity() but can be swapped out for testing. Unlike the default, this
+		 * reads the machine afresh each time.
+		 */
+		affinity_t(const std::string_view topologyRoot, const affinitySource_t affinitySource = sched_getaffinity,
+			const cgroupLimits_t &cgroup = cgroupLimits_t{}) :
+			affinity_t{inventoryOf(topologyRoot, affinitySource, cgroup)} { }
+
+		// Builds an affinity over a run of another's processors, wrapping around if it runs out
+		affinity_t(const affinity_t &affinity, const std::size_t begin, const std::size_t count)
+		{
+			const auto total{affinity.processors.size()};
+			for (std::size_t i{}; total && i < count; ++i)
+				processors.push_back(affinity.processors[(begin + i) % total]);
+		}
+
+		// Builds an affinity over a run of another's processors, taking those that are preferred before the rest
+		template<typename preferred_t> affinity_t(const affinity_t &affinity, const std::size_t begin,
+			const std::size_t count, preferred_t preferred)
+		{
+			auto ordered{affinity.processors};
+			std::stable_partition(ordered.begin(), ordered.end(), preferred);
+			const auto total{ordered.size()};
+			for (std::size_t i{}; total && i < count; ++i)
+				processors.push_back(ordered[(begin + i) % total]);
 		}
 
 		[[nodiscard]] auto numProcessors() const noexcept { return processors.size(); }
 		[[nodiscard]] auto begin() const noexcept { return processors.begin(); }
 		[[nodiscard]] auto end() const noexcept { return processors.end(); }
 		[[nodiscard]] auto indexSequence() const noexcept { return indexSequence_t{0, numProcessors()}; }
+		[[nodiscard]] auto setSource() const noexcept { return setSource_; }
+		[[nodiscard]] auto countSource() const noexcept { return countSource_; }
 
 		void pinThreadTo(std::thread &thread, const std::size_t index) const
 			{ pinTo(thread.native_handle(), index); }
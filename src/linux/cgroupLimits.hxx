@@ -0,0 +1,94 @@
+#ifndef CGROUP_LIMITS__HXX
+#define CGROUP_LIMITS__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include "processorPlacement.hxx"
+
+using namespace std::literals::string_view_literals;
+
+namespace pcat
+{
+	constexpr static auto cgroupRoot{"/sys/fs/cgroup"sv};
+	constexpr static auto cgroupMembership{"/proc/self/cgroup"sv};
+
+	/*!
+	 * The CPU limits placed on us by the cgroup (v2) we're running in, as under Slurm or
+	 * Kubernetes. cpu.max is a quota of CPU time per period, which any cgroup between ours
+	 * and the root can set, and which comes out as the number of CPUs' worth of time we
+	 * can use. cpuset.cpus.effective is the set of CPUs we may be scheduled on.
+	 *
+	 * The cgroup hierarchy is read from under root, and which cgroup we are in from the
+	 * membership file, so both can be pointed at a fake tree for testing. With cgroup v1,
+	 * or no cgroups at all, there are no limits.
+	 */
+	struct cgroupLimits_t final
+	{
+	private:
+		std::size_t cpuQuota_{0};
+		std::vector<uint32_t> cpuset_{};
+
+		// Finds the path of our cgroup from the "0::/path" line that cgroup v2 gives in the membership file
+		[[nodiscard]] static std::string cgroupPath(const std::string_view membership)
+		{
+			const auto contents{readSysfsFile(std::string{membership})};
+			std::string_view lines{contents};
+			while (!lines.empty())
+			{
+				const auto end{lines.find('\n')};
+				const auto line{lines.substr(0, end)};
+				lines.remove_prefix(end == std::string_view::npos ? lines.size() : end + 1U);
+				if (line.substr(0, 3) == "0::"sv)
+					return std::string{line.substr(3)};
+			}
+			return {};
+		}
+
+		// Turns a cpu.max of "quota period" into how many CPUs that is, rounded up, or 0 if it is "max"
+		[[nodiscard]] static std::size_t parseQuota(const std::string_view cpuMax)
+		{
+			const auto space{cpuMax.find(' ')};
+			if (space == std::string_view::npos)
+				return 0U;
+			const auto quota{args::toCount(cpuMax.substr(0, space))};
+			auto period{cpuMax.substr(space + 1U)};
+			while (!period.empty() && period.back() == '\n')
+				period.remove_suffix(1);
+			const auto length{args::toCount(period)};
+			if (!quota || !length)
+				return 0U;
+			return std::max<std::size_t>((quota + length - 1U) / length, 1U);
+		}
+
+	public:
+		cgroupLimits_t(const std::string_view root = cgroupRoot, const std::string_view membership = cgroupMembership)
+		{
+			auto path{cgroupPath(membership)};
+			if (path.empty() || path.front() != '/')
+				return;
+			cpuset_ = parseCPUList(readSysfsFile(std::string{root} + path + "/cpuset.cpus.effective"));
+
+			// Walk up to the root, as the tightest quota set by any of our ancestors is the one that applies
+			while (true)
+			{
+				const auto quota{parseQuota(readSysfsFile(std::string{root} + path + "/cpu.max"))};
+				if (quota && (!cpuQuota_ || quota < cpuQuota_))
+					cpuQuota_ = quota;
+				if (path.size() <= 1U)
+					break;
+				path.erase(std::max<std::size_t>(path.rfind('/'), 1U));
+			}
+		}
+
+		// The number of CPUs' worth of time we may use, or 0 if there is no quota
+		[[nodiscard]] auto cpuQuota() const noexcept { return cpuQuota_; }
+		// The CPUs our cgroup may run on, or nothing if that isn't known
+		[[nodiscard]] const auto &cpuset() const noexcept { return cpuset_; }
+	};
+} // namespace pcat
+
+#endif /*CGROUP_LIMITS__HXX*/
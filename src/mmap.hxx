@@ -5,6 +5,7 @@
 #ifndef _WINDOWS
 #	include <unistd.h>
 #	include <sys/mman.h>
+#	include <sys/uio.h>
 #else
 #	include <io.h>
 #	define WIN32_LEAN_AND_MEAN
@@ -15,6 +16,7 @@
 #endif
 #include <stdexcept>
 #include <cstring>
+#include <cerrno>
 #include <cassert>
 #include <substrate/fd>
 
@@ -32,6 +34,65 @@ namespace pcat
 	const auto MADV_DONTDUMP{0};
 #endif
 
+#ifndef _WINDOWS
+	// Reads exactly length bytes of file from offset into buffer, retrying short reads
+	[[nodiscard]] inline bool readAt(const substrate::fd_t &file, void *const buffer, off_t offset, off_t length) noexcept
+	{
+		auto *dest = static_cast<uint8_t *>(buffer);
+		while (length)
+		{
+			const auto result = pread(file, dest, length, offset);
+			if (result < 0 && errno == EINTR)
+				continue;
+			// Reading nothing means the file shrank out from under us
+			else if (result <= 0)
+			{
+				if (!result)
+					errno = EIO;
+				return false;
+			}
+			dest += result;
+			offset += result;
+			length -= result;
+		}
+		return true;
+	}
+
+	/*!
+	 * Reads as much of length bytes of file from offset into buffer as can be had without
+	 * waiting on storage, giving how much was read or -1 on error. Where the kernel can't
+	 * tell us that (RWF_NOWAIT is not supported), this reads everything, waiting as needed.
+	 */
+	[[nodiscard]] inline off_t readCachedAt(const substrate::fd_t &file, void *const buffer, const off_t offset,
+		const off_t length) noexcept
+	{
+#ifdef RWF_NOWAIT
+		auto *const dest = static_cast<uint8_t *>(buffer);
+		off_t amount{};
+		while (amount < length)
+		{
+			iovec request{dest + amount, std::size_t(length - amount)};
+			const auto result = preadv2(file, &request, 1, offset + amount, RWF_NOWAIT);
+			if (result < 0 && errno == EINTR)
+				continue;
+			else if (result < 0 && errno == EAGAIN)
+				break;
+			else if (result < 0 && errno == EOPNOTSUPP)
+				return readAt(file, dest + amount, offset + amount, length - amount) ? length : -1;
+			else if (result < 0)
+				return -1;
+			// Leave anything past the end of the file for the slow path to complain about
+			else if (!result)
+				break;
+			amount += result;
+		}
+		return amount;
+#else
+		return readAt(file, buffer, offset, length) ? length : -1;
+#endif
+	}
+#endif
+
 	struct mmap_t final
 	{
 	private:
@@ -176,6 +237,14 @@ namespace pcat
 
 		[[nodiscard]] bool advise(const int32_t adviceFlags) const noexcept
 			{ return madvise(_addr, _len, adviceFlags) == 0; }
+
+		// Reads length bytes of file from offset straight into the mapping at idx, rather than mapping the file too
+		[[nodiscard]] bool fill(const off_t idx, const fd_t &file, const off_t offset, const off_t length) const
+		{
+			auto *const dest = index(idx);
+			assert(length <= _len - idx);
+			return readAt(file, dest, offset, length);
+		}
 #else
 		[[nodiscard]] bool sync() const noexcept { return sync(_len); }
 		[[nodiscard]] bool sync(const off_t length) const noexcept { return FlushViewOfFile(_addr, length); }
@@ -0,0 +1,110 @@
+#ifndef NUMA_TOPOLOGY__HXX
+#define NUMA_TOPOLOGY__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#ifndef _WINDOWS
+#	include <dirent.h>
+#	include <sched.h>
+#endif
+#include "sysfs.hxx"
+
+using namespace std::literals::string_view_literals;
+
+namespace pcat
+{
+	/*!
+	 * The NUMA topology of the machine, as the CPUs that belong to each memory node. This
+	 * is read from sysfs, from the node<N>/cpulist files under the given root, so it can be
+	 * pointed at a fake tree for testing. Where there is no topology to be read, as on
+	 * machines without NUMA or on Windows, everything is treated as being on a single node.
+	 */
+	struct numaTopology_t final
+	{
+	private:
+		// The node each CPU is on, indexed by CPU number
+		std::vector<std::size_t> cpuNodes{};
+		// The ID sysfs gives each node, indexed by our numbering of them
+		std::vector<std::size_t> nodeIDs{};
+		std::size_t nodes_{1};
+
+#ifndef _WINDOWS
+		void readTopology(const std::string_view root)
+		{
+			std::string path{root};
+			DIR *const dir{opendir(path.c_str())};
+			if (!dir)
+				return;
+			std::vector<std::pair<std::size_t, std::vector<uint32_t>>> nodeCPUs{};
+			while (const auto *const entry{readdir(dir)})
+			{
+				const std::string_view name{entry->d_name};
+				if (name.substr(0, 4) != "node"sv || name.size() == 4 ||
+					name.find_first_not_of("0123456789"sv, 4) != std::string_view::npos)
+					continue;
+				auto cpus{parseCPUList(readSysfsFile(path + '/' + std::string{name} + "/cpulist"))};
+				// Memory-only nodes have no CPUs, so have no workers to place anything on
+				if (!cpus.empty())
+					nodeCPUs.emplace_back(std::stoul(std::string{name.substr(4)}), std::move(cpus));
+			}
+			closedir(dir);
+			if (nodeCPUs.size() < 2)
+				return;
+
+			// Renumber the nodes densely, in order, so they can index arrays of per-node state
+			std::sort(nodeCPUs.begin(), nodeCPUs.end(),
+				[](const auto &a, const auto &b) noexcept { return a.first < b.first; });
+			nodes_ = nodeCPUs.size();
+			for (std::size_t node{}; node < nodes_; ++node)
+			{
+				nodeIDs.push_back(nodeCPUs[node].first);
+				for (const auto cpu : nodeCPUs[node].second)
+				{
+					if (cpu >= cpuNodes.size())
+						cpuNodes.resize(cpu + 1U);
+					cpuNodes[cpu] = node;
+				}
+			}
+		}
+#endif
+
+	public:
+		numaTopology_t(const std::string_view root = "/sys/devices/system/node"sv)
+		{
+#ifndef _WINDOWS
+			readTopology(root);
+#else
+			static_cast<void>(root);
+#endif
+		}
+
+		[[nodiscard]] auto nodes() const noexcept { return nodes_; }
+		[[nodiscard]] std::size_t nodeOf(const std::size_t cpu) const noexcept
+			{ return cpu < cpuNodes.size() ? cpuNodes[cpu] : 0U; }
+		// Maps a node ID from sysfs on to our numbering of the nodes, giving nodes() for one we don't know of
+		[[nodiscard]] std::size_t indexOf(const std::size_t nodeID) const noexcept
+		{
+			const auto node{std::find(nodeIDs.begin(), nodeIDs.end(), nodeID)};
+			return node == nodeIDs.end() ? nodes_ : std::size_t(node - nodeIDs.begin());
+		}
+
+		// The node of the CPU the calling thread is running on right now
+		[[nodiscard]] std::size_t currentNode() const noexcept
+		{
+#ifndef _WINDOWS
+			if (nodes_ == 1)
+				return 0U;
+			const auto cpu{sched_getcpu()};
+			return cpu < 0 ? 0U : nodeOf(std::size_t(cpu));
+#else
+			return 0U;
+#endif
+		}
+	};
+} // namespace pcat
+
+#endif /*NUMA_TOPOLOGY__HXX*/
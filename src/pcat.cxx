@@ -2,20 +2,32 @@
 #include <cstdio>
 #include <cstring>
 #include <cerrno>
+#include <string>
 #include <string_view>
 #include <array>
 #include <vector>
-#include <numeric>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
 #include <substrate/fd>
 #include <substrate/utility>
 #include <substrate/console>
 #ifndef _WINDOWS
 #	include <sys/file.h>
+#	include <sys/resource.h>
+#	include <sys/sysmacros.h>
 #endif
 #include <version.hxx>
 #include "args.hxx"
 #include "help.hxx"
 #include "chunking.hxx"
+#include "deviceGroups.hxx"
+#include "fileList.hxx"
+#include "directoryWalk.hxx"
+#include "threadPool.hxx"
+#include "workloadPolicy.hxx"
 
 using namespace std::literals::string_view_literals;
 using substrate::console;
@@ -37,10 +49,33 @@ namespace pcat
 		{"-t"sv, argType_t::threads},
 		{"--core-pins"sv, argType_t::pinning},
 		{"-c"sv, argType_t::pinning},
-		{"--algorithm"sv, argType_t::algorithm}
+		{"--algorithm"sv, argType_t::algorithm},
+		{"--schedule"sv, argType_t::schedule},
+		{"--device-threads"sv, argType_t::deviceThreads},
+		{"--stats"sv, argType_t::stats},
+		{"--readers"sv, argType_t::readers},
+		{"--writers"sv, argType_t::writers},
+		{"--max-open"sv, argType_t::maxOpen},
+		{"--files-from"sv, argType_t::filesFrom},
+		{"--recursive"sv, argType_t::recursive},
+		{"-r"sv, argType_t::recursive},
+		{"--sort"sv, argType_t::sort},
+		{"--engine"sv, argType_t::engine},
+		{"--cached-first"sv, argType_t::cachedFirst},
+		{"--physical-order"sv, argType_t::physicalOrder},
+		{"--placement"sv, argType_t::placement},
+		{"--verbose"sv, argType_t::verbose},
+		{"-v"sv, argType_t::verbose},
+		{"--block-size"sv, argType_t::blockSize},
+		{"--stripe-size"sv, argType_t::stripeSize},
+		{"--stripe-count"sv, argType_t::stripeCount}
 	})};
 
-	std::vector<fd_t> inputFiles{};
+	inputFiles_t inputFiles{};
+	deferredReads_t deferredReads{};
+	blockSize_t blockSize{};
+	stripeLayout_t stripeLayout{};
+	deviceGroups_t deviceGroups{};
 	fd_t outputFile{};
 	std::atomic<bool> sync{true};
 
@@ -76,43 +111,201 @@ namespace pcat
 	}
 #endif
 
-	bool checkFile(const std::string_view fileName) noexcept
+	// An input as opened and checked by the gather workers, waiting to be added to the inputs in order
+	struct gatheredFile_t final
 	{
-		fd_t file{fileName.data(), O_RDWR | O_NOCTTY};
-		// If the file wasn't able to be opened, or is not stat()-able, discard it.
-		if (!file.valid() || file.length() <= 0)
+		fd_t file{};
+		inputMetadata_t metadata{};
+	};
+
+	struct gatherState_t final
+	{
+		std::vector<std::string_view> fileNames{};
+		std::unique_ptr<gatheredFile_t []> files{}; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+		std::atomic<std::size_t> nextFile{0};
+		std::atomic<bool> failed{false};
+		bool lazy{false};
+	};
+
+	// Opening inputs is bound by metadata latency rather than CPU, so this is not tied to the processor count
+	constexpr static std::size_t maxGatherThreads{16U};
+
+	bool checkFile(const std::string &fileName, gatheredFile_t &result) noexcept
+	{
+		fd_t file{fileName.c_str(), O_RDWR | O_NOCTTY};
+		// If the file wasn't able to be opened, discard it.
+		if (!file.valid())
+			return false;
+		// Gather everything we need to know about the file in one go, discarding it if it's not stat()-able
+		const auto metadata{inputMetadata_t::of(file)};
+		if (metadata.length <= 0)
 			return false;
 #ifndef _WINDOWS
 		// Change it from just open, to exclusive access so it can't be removed or changed from under us.
 		if (!lockFile(file))
 			return false;
 #endif
-		inputFiles.emplace_back(std::move(file));
+		result = {std::move(file), metadata};
 		return true;
 	}
 
-	bool gatherFiles() noexcept
+	// Lazily opened inputs only have their metadata gathered up front, by path
+	bool checkPath(const std::string &fileName, gatheredFile_t &result) noexcept
 	{
-		for (const auto &arg : *::args)
+		const auto metadata{inputMetadata_t::of(fileName.c_str())};
+		if (metadata.length <= 0)
+			return false;
+		result.metadata = metadata;
+		return true;
+	}
+
+	int32_t gatherWorker(gatherState_t *const state) try
+	{
+		const auto count{state->fileNames.size()};
+		// Entries from --files-from aren't NUL terminated, so each name is copied out into one reused buffer to open
+		std::string fileName{};
+		for (auto index{state->nextFile++}; index < count && !state->failed; index = state->nextFile++)
+		{
+			fileName.assign(state->fileNames[index]);
+			auto &file{state->files[index]};
+			if (!(state->lazy ? checkPath(fileName, file) : checkFile(fileName, file)))
+			{
+				state->failed = true;
+				return EINVAL;
+			}
+		}
+		return 0;
+	}
+	catch (const std::bad_alloc &)
+	{
+		state->failed = true;
+		return ENOMEM;
+	}
+
+	// Finds the files under a directory given as an input
+	bool walkDirectory(const std::string_view path, std::vector<std::string> &files)
+	{
+		const auto *const sort{dynamic_cast<args::argSort_t *>(::args->find(argType_t::sort))};
+		directoryWalk_t walk{path, sort ? sort->sort() : args::sort_t::lexical};
 		{
-			if (arg->type() != argType_t::unrecognised)
-				continue;
-			const auto &file{dynamic_cast<args::argUnrecognised_t &>(*arg)};
-			if (!checkFile(file.argument()))
-				return false;
+			threadPool_t walkThreads{walkDirectories, affinity_t{affinity_t{}, 0, maxGatherThreads}, maxGatherThreads};
+			for (std::size_t worker{}; worker < maxGatherThreads; ++worker)
+			{
+				if (walkThreads.queue(&walk))
+					break;
+			}
+			[[maybe_unused]] const auto result{walkThreads.finish()};
+		}
+		if (!walk.valid())
+		{
+			console.error("Failed to walk the directory "sv, path, ": "sv, std::strerror(walk.error()));
+			return false;
 		}
+		files = walk.files();
 		return true;
 	}
 
-	std::size_t totalSize() noexcept
+	// Works out how many inputs may be held open at once, giving 0 if they can all be opened up front
+	std::size_t openBudget(const std::size_t inputs) noexcept
 	{
-		constexpr std::size_t zero{};
-		return std::accumulate(inputFiles.begin(), inputFiles.end(), zero,
-			[](const std::size_t count, const fd_t &file) noexcept -> std::size_t
-				{ return count + static_cast<std::size_t>(file.length()); }
-		);
+		const auto *const maxOpen{dynamic_cast<args::argMaxOpen_t *>(::args->find(argType_t::maxOpen))};
+		if (maxOpen)
+			return maxOpen->count();
+#ifndef _WINDOWS
+		rlimit limit{};
+		if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY)
+			return 0;
+		// Leave half the limit spare for the output, the console and the thread pools
+		const auto available{std::max<std::size_t>(std::size_t(limit.rlim_cur) / 2U, 1U)};
+		return inputs > available ? available : 0U;
+#else
+		return 0;
+#endif
 	}
 
+	/*!
+	 * Opening, stat()ing and locking each input is done by a bounded set of workers which
+	 * claim inputs in turn and leave what they find in that input's slot. This lets the
+	 * metadata round trips for many inputs overlap, which on Lustre and GPFS can otherwise
+	 * take longer than moving the data. The results are then added to the inputs in
+	 * argument order on this thread.
+	 */
+	bool gatherFiles() noexcept try
+	{
+		gatherState_t state{};
+		// The entries of any input lists are views into the lists, so these must live until the inputs are added
+		std::vector<std::unique_ptr<fileList_t>> fileLists{};
+		// Likewise for the files found under any directories given, which a deque keeps in place as more are added
+		std::deque<std::vector<std::string>> walkedFiles{};
+		const auto recursive{::args->find(argType_t::recursive) != nullptr};
+		for (const auto &arg : *::args)
+		{
+			if (arg->type() == argType_t::unrecognised)
+			{
+				const auto fileName{dynamic_cast<args::argUnrecognised_t &>(*arg).argument()};
+				if (recursive && isDirectory(fileName.data()))
+				{
+					auto &files{walkedFiles.emplace_back()};
+					if (!walkDirectory(fileName, files))
+						return false;
+					state.fileNames.insert(state.fileNames.end(), files.begin(), files.end());
+				}
+				else
+					state.fileNames.emplace_back(fileName);
+			}
+			else if (arg->type() == argType_t::filesFrom)
+			{
+				const auto fileName{dynamic_cast<args::argFilesFrom_t &>(*arg).fileName()};
+				const auto &fileList{*fileLists.emplace_back(substrate::make_unique<fileList_t>(fileName))};
+				if (!fileList.valid())
+				{
+					console.error("Could not read the list of inputs in "sv, fileName, ": "sv,
+						std::strerror(fileList.error()));
+					return false;
+				}
+				const auto &entries{fileList.entries()};
+				state.fileNames.insert(state.fileNames.end(), entries.begin(), entries.end());
+			}
+		}
+		const auto count{state.fileNames.size()};
+		const auto budget{openBudget(count)};
+		state.lazy = budget != 0U;
+		// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+		state.files = substrate::make_unique<gatheredFile_t []>(count);
+
+		{
+			const auto workers{std::min(count, maxGatherThreads)};
+			threadPool_t gatherThreads{gatherWorker, affinity_t{affinity_t{}, 0, workers}, workers};
+			for (std::size_t worker{}; worker < workers; ++worker)
+			{
+				if (gatherThreads.queue(&state))
+					state.failed = true;
+			}
+			if (gatherThreads.finish())
+				state.failed = true;
+		}
+		if (state.failed)
+			return false;
+
+		inputFiles.lazy(budget);
+		for (std::size_t index{}; index < count; ++index)
+		{
+			auto &[file, metadata] = state.files[index];
+			if (state.lazy)
+				inputFiles.emplace_back(state.fileNames[index], metadata);
+			else
+				inputFiles.emplace_back(std::move(file), metadata);
+			deviceGroups.add(metadata.device, metadata.length);
+		}
+		return true;
+	}
+	catch (const std::bad_alloc &)
+		{ return false; }
+	catch (const std::system_error &)
+		{ return false; }
+
+	std::size_t totalSize() noexcept { return static_cast<std::size_t>(inputFiles.totalLength()); }
+
 	bool openOutputFile(int32_t &error)
 	{
 		const auto fileName = dynamic_cast<args::argOutputFile_t *>(::args->find(argType_t::outputFile))->fileName();
@@ -133,27 +326,210 @@ namespace pcat
 	void closeFiles() noexcept
 	{
 #ifndef _WINDOWS
-		for (const auto &file : inputFiles)
-			unlockFile(file);
+		// Lazily opened inputs are never locked, so only those opened up front need unlocking
+		if (!inputFiles.lazy())
+		{
+			for (const auto &file : inputFiles)
+				unlockFile(file);
+		}
 #endif
 		inputFiles.clear();
+		deviceGroups.clear();
 	}
 
-	int32_t chunkedCopy() noexcept try
+	void printStats(const std::chrono::steady_clock::duration elapsed) noexcept
 	{
-		const auto algorithm{dynamic_cast<args::argAlgorithm_t *>(::args->find(argType_t::algorithm))};
-		sync = !::args->find(argType_t::async);
-		if (!algorithm || algorithm->algorithm() == args::algorithm_t::blockLinear)
+		console.info("Inputs were grouped into "sv, deviceGroups.size(), " device groups:"sv);
+		for (const auto &group : deviceGroups)
+		{
+			const auto device{group.device()};
+#ifndef _WINDOWS
+			console.info("\tDevice "sv, major(device), ':', minor(device), ": "sv, group.files(),
+				" files totaling "sv, group.bytes(), " bytes, using up to "sv, group.workers(), " threads"sv);
+#else
+			console.info("\tDevice "sv, device, ": "sv, group.files(), " files totaling "sv,
+				group.bytes(), " bytes, using up to "sv, group.workers(), " threads"sv);
+#endif
+		}
+
+		const auto bytes{totalSize()};
+		const auto time{std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()};
+		// Compute the rate in KiB/s to keep some precision without needing to resort to floating point,
+		// scaling the bytes per microsecond and the remainder separately as bytes * 1000000 overflows past ~18TB
+		const auto micros{std::size_t(std::max<decltype(time)>(time, 0))};
+		const auto rate{micros ?
+			((bytes / micros) * 1000000U + ((bytes % micros) * 1000000U) / micros) / 1024U : 0U};
+		console.info("Copied "sv, bytes, " bytes in "sv, time, "us ("sv, rate, "KiB/s)"sv);
+	}
+
+	// Reports which processors the copy threads have been placed on, for --verbose
+	void printPlacement()
+	{
+		const affinity_t affinity{};
+#ifndef _WINDOWS
+		std::string processors{};
+		for (const auto processor : affinity)
+		{
+			if (!processors.empty())
+				processors += ", "sv;
+			processors += std::to_string(processor);
+		}
+		console.info("Placing up to "sv, affinity.numProcessors(), " copy threads on CPUs "sv, processors);
+		console.info("\tCPUs chosen from "sv, affinity.setSource(), ", thread count set by "sv, affinity.countSource());
+#else
+		console.info("Placing up to "sv, affinity.numProcessors(), " copy threads"sv);
+#endif
+		if (throughput::automatic())
+			console.info("\tHow many of these copy at once is adjusted to the throughput seen"sv);
+	}
+
+	/*!
+	 * Sets up the output's stripe layout from --stripe-size and --stripe-count. Whatever isn't
+	 * given is asked of Lustre, and failing that the stripe size is taken to be the output's
+	 * preferred IO size, which on GPFS is its block size, with the stripe count left unknown.
+	 */
+	void configureStripes()
+	{
+		const auto *const size{dynamic_cast<args::argStripeSize_t *>(::args->find(argType_t::stripeSize))};
+		const auto *const count{dynamic_cast<args::argStripeCount_t *>(::args->find(argType_t::stripeCount))};
+		if (!size && !count)
+			return;
+		auto detected{stripeLayout_t::fromLustre(outputFile)};
+		if (!detected.enabled())
+			detected = {off_t(inputMetadata_t::of(outputFile).blockSize), 1U};
+		stripeLayout =
+		{
+			size && !size->automatic() ? off_t(size->size()) : detected.size(),
+			count ? count->count() : detected.count()
+		};
+	}
+
+	/*!
+	 * Sets up the block size from --block-size, working out where to start from the storage for
+	 * 'auto'. With a stripe layout and no --block-size, blocks are one stripe each so each block
+	 * goes to a single storage target, or as few stripes as make up the default block size when
+	 * the stripes are smaller than that.
+	 */
+	void configureBlockSize()
+	{
+		const auto *const size{dynamic_cast<args::argBlockSize_t *>(::args->find(argType_t::blockSize))};
+		if (!size)
+		{
+			if (stripeLayout.enabled())
+			{
+				const auto stripe{stripeLayout.size()};
+				blockSize.fixed(((transferBlockSize + stripe - 1) / stripe) * stripe);
+			}
+			return;
+		}
+		if (!size->automatic())
+		{
+			blockSize.fixed(off_t(size->size()));
+			return;
+		}
+		auto preferred{std::max(inputMetadata_t::of(outputFile).blockSize, std::size_t(stripeLayout.size()))};
+		for (std::size_t index{}; index < inputFiles.size(); ++index)
+			preferred = std::max(preferred, inputFiles.blockSizeOf(index));
+		blockSize.adapt(off_t(preferred), outputFile.length(), affinity_t{}.numProcessors());
+	}
+
+	[[nodiscard]] std::string_view algorithmName(const args::algorithm_t algorithm) noexcept
+	{
+		switch (algorithm)
+		{
+			case args::algorithm_t::chunkSpans:
+				return "chunkSpans"sv;
+			case args::algorithm_t::pipeline:
+				return "pipeline"sv;
+			default:
+				return "blockLinear"sv;
+		}
+	}
+
+	// Sets an option the workload policy picked, unless it was given on the command line which always wins
+	template<typename node_t> void fillIn(const argType_t type, const std::string_view value)
+	{
+		if (::args->find(type))
+			return;
+		// Failing to add the option just leaves the setting at its default
+		static_cast<void>(::args->add(substrate::make_unique<node_t>(value)));
+	}
+
+	/*!
+	 * Works out how to do the copy for --algorithm=auto from a profile of the inputs and output.
+	 * The engine, schedule, block size, stripe and thread count settings picked to go with the
+	 * algorithm are filled in as options, so everything after sets them up just as if they'd
+	 * been given. With --verbose, what was picked and why is reported.
+	 */
+	args::algorithm_t chooseAlgorithm()
+	{
+		const auto profile{profileWorkload(outputFile, affinity_t{}.numProcessors())};
+		const auto policy{choosePolicy(profile)};
+		if (policy.algorithm == args::algorithm_t::chunkSpans && policy.schedule == args::schedule_t::guidedSpans)
+			fillIn<args::argSchedule_t>(argType_t::schedule, "guided"sv);
+		if (policy.engine == args::engine_t::nowait)
+			fillIn<args::argEngine_t>(argType_t::engine, "nowait"sv);
+		// Either stripe option turns stripe alignment on, so a stripe count alone is left to do so
+		if (policy.alignStripes && !::args->find(argType_t::stripeCount))
+			fillIn<args::argStripeSize_t>(argType_t::stripeSize, "auto"sv);
+		if (policy.tuneBlockSize)
+			fillIn<args::argBlockSize_t>(argType_t::blockSize, "auto"sv);
+		if (policy.tuneThreads)
+			fillIn<args::argThreads_t>(argType_t::threads, "auto"sv);
+
+		if (::args->find(argType_t::verbose))
+		{
+			console.info("Picked the '"sv, algorithmName(policy.algorithm), "' algorithm for "sv, profile.files,
+				" inputs totaling "sv, profile.totalLength, " bytes on "sv, filesystem::nameOf(profile.inputs),
+				" to an output on "sv, filesystem::nameOf(profile.output));
+			for (const auto &reason : policy.reasons)
+				console.info('\t', reason);
+		}
+		return policy.algorithm;
+	}
+
+	int32_t runAlgorithm(const args::algorithm_t algorithm)
+	{
+		if (algorithm == args::algorithm_t::blockLinear)
 			return pcat::algorithm::blockLinear::chunkedCopy();
-		else if (algorithm->algorithm() == args::algorithm_t::chunkSpans)
+		else if (algorithm == args::algorithm_t::chunkSpans)
 			return pcat::algorithm::chunkSpans::chunkedCopy();
-		else if (algorithm->algorithm() == args::algorithm_t::invalid)
+		else if (algorithm == args::algorithm_t::pipeline)
+			return pcat::algorithm::pipeline::chunkedCopy();
+		else if (algorithm == args::algorithm_t::invalid)
 		{
 			errno = EINVAL;
 			return 1;
 		}
 		return 0;
 	}
+
+	int32_t chunkedCopy() noexcept try
+	{
+		const auto *const algorithmArg{dynamic_cast<args::argAlgorithm_t *>(::args->find(argType_t::algorithm))};
+		auto algorithm{algorithmArg ? algorithmArg->algorithm() : args::algorithm_t::blockLinear};
+		sync = !::args->find(argType_t::async);
+		// The workload policy has to fill in its options before any of them are acted on
+		if (algorithm == args::algorithm_t::automatic)
+			algorithm = chooseAlgorithm();
+		deviceGroups.locate(inputMetadata_t::of(outputFile).device);
+		configureStripes();
+		configureBlockSize();
+		if (::args->find(argType_t::verbose))
+		{
+			printPlacement();
+			console.info("Copying in blocks of "sv, blockSize.current(), " bytes"sv,
+				blockSize.adaptive() ? ", tuned as the copy runs"sv : ""sv);
+			if (stripeLayout.enabled())
+				console.info("Aligning blocks to stripes of "sv, stripeLayout.size(), " bytes over "sv,
+					stripeLayout.count(), stripeLayout.count() == 1U ? " storage target"sv : " storage targets"sv);
+		}
+		const auto startTime{std::chrono::steady_clock::now()};
+		const auto result{runAlgorithm(algorithm)};
+		if (!result && ::args->find(argType_t::stats))
+			printStats(std::chrono::steady_clock::now() - startTime);
+		return result;
+	}
 	catch (const std::bad_cast &error)
 	{
 		console.error("Failed to cast argument to proper type: "sv, error.what());
@@ -0,0 +1,143 @@
+#ifndef PHYSICAL_ORDER__HXX
+#define PHYSICAL_ORDER__HXX
+
+#include <cstdint>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <sys/types.h>
+#ifdef __linux__
+#	include <sys/ioctl.h>
+#	include <linux/fs.h>
+#	include <linux/fiemap.h>
+#endif
+#include <substrate/fd>
+#include "chunking.hxx"
+
+namespace pcat
+{
+	using substrate::fd_t;
+	using substrate::off_t;
+
+	// How many extents are asked for in each FS_IOC_FIEMAP call
+	constexpr static uint32_t fiemapBatch{256U};
+
+	// A run of an input that lies contiguously on its device
+	struct physicalExtent_t final
+	{
+		// Where the extent starts in the input
+		off_t offset{};
+		off_t length{};
+		// Where the extent starts on the input's device
+		uint64_t physical{};
+	};
+
+	/*!
+	 * Reads where the length bytes from offset into file lie on its device, as extents in
+	 * the order they come in the file that between them cover the whole range. Holes, and
+	 * data the filesystem hasn't placed yet, are given the location just past the extent
+	 * before them so they sort alongside it, or the start of the device if there isn't one.
+	 * This is asked of the filesystem with FIEMAP, so gives nothing for filesystems that
+	 * can't say, as with most network filesystems, and on Windows.
+	 */
+	[[nodiscard]] inline std::vector<physicalExtent_t> readExtents(const fd_t &file, const off_t offset,
+		const off_t length)
+	{
+		std::vector<physicalExtent_t> extents{};
+#ifdef __linux__
+		if (!file.valid() || length <= 0)
+			return extents;
+		// The request header followed by room for a batch of extents, as FS_IOC_FIEMAP takes them
+		std::vector<uint64_t> buffer((sizeof(fiemap) + (fiemapBatch * sizeof(fiemap_extent))) / sizeof(uint64_t));
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		auto *const request{reinterpret_cast<fiemap *>(buffer.data())};
+		const auto end{offset + length};
+		auto covered{offset};
+		uint64_t next{};
+		for (bool last{false}; !last && covered < end;)
+		{
+			std::fill(buffer.begin(), buffer.end(), 0U);
+			request->fm_start = uint64_t(covered);
+			request->fm_length = uint64_t(end - covered);
+			request->fm_extent_count = fiemapBatch;
+			if (ioctl(int32_t{file}, FS_IOC_FIEMAP, request) != 0)
+				return {};
+			const auto start{covered};
+			for (uint32_t index{}; index < request->fm_mapped_extents; ++index)
+			{
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+				const auto &extent{request->fm_extents[index]};
+				last = extent.fe_flags & FIEMAP_EXTENT_LAST;
+				const auto begin{std::max(off_t(extent.fe_logical), covered)};
+				const auto finish{std::min(off_t(extent.fe_logical + extent.fe_length), end)};
+				if (begin >= finish)
+					continue;
+				if (begin > covered)
+					extents.push_back({covered, begin - covered, next});
+				const auto physical
+				{
+					extent.fe_flags & FIEMAP_EXTENT_UNKNOWN ? next :
+						extent.fe_physical + uint64_t(begin - off_t(extent.fe_logical))
+				};
+				extents.push_back({begin, finish - begin, physical});
+				covered = finish;
+				next = physical + uint64_t(finish - begin);
+			}
+			// No extents at all, or none past what's already covered, means the rest is a hole
+			if (covered == start)
+				break;
+		}
+		if (covered < end)
+			extents.push_back({covered, end - covered, next});
+#else
+		static_cast<void>(file);
+		static_cast<void>(offset);
+		static_cast<void>(length);
+#endif
+		return extents;
+	}
+
+	// Finds which device, and where on it, the input the given offset of the output comes from lies
+	[[nodiscard]] inline std::pair<dev_t, uint64_t> physicalLocation(const off_t offset)
+	{
+		const auto [file, inputOffset] = inputFiles.locate(offset);
+		if (file == inputFiles.end())
+			return {};
+		const auto extents{readExtents(*file, inputOffset, 1)};
+		return {inputFiles.deviceOf(inputFiles.indexOf(file)), extents.empty() ? 0U : extents.front().physical};
+	}
+
+	/*!
+	 * Reorders a plan of ranges of the output by where the inputs they come from lie on
+	 * their devices, so each device is read from in one sweep across it rather than seeking
+	 * back and forth as fragmented inputs would have it. Only the order ranges are copied
+	 * in changes, with each still written to its own place in the output. Ranges that come
+	 * from the same place keep the order they had.
+	 *
+	 * locationOf gives the device and the location on it of an entry in the plan. In lazy
+	 * mode the inputs aren't open yet, so there's nothing to ask and the plan is left as it is.
+	 */
+	template<typename range_t, typename locationOf_t> void physicalOrder(std::vector<range_t> &plan,
+		locationOf_t locationOf)
+	{
+		if (inputFiles.lazy())
+			return;
+		std::vector<std::tuple<dev_t, uint64_t, std::size_t>> order{};
+		order.reserve(plan.size());
+		for (std::size_t index{}; index < plan.size(); ++index)
+		{
+			const auto [device, physical] = locationOf(plan[index]);
+			order.emplace_back(device, physical, index);
+		}
+		std::sort(order.begin(), order.end());
+
+		std::vector<range_t> ordered{};
+		ordered.reserve(plan.size());
+		for (const auto &entry : order)
+			ordered.push_back(std::move(plan[std::get<2>(entry)]));
+		plan = std::move(ordered);
+	}
+} // namespace pcat
+
+#endif /*PHYSICAL_ORDER__HXX*/
@@ -0,0 +1,146 @@
+#ifndef PROCESSOR_PLACEMENT__HXX
+#define PROCESSOR_PLACEMENT__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <tuple>
+#include <numeric>
+#include <algorithm>
+#include "args.hxx"
+#include "sysfs.hxx"
+
+using namespace std::literals::string_view_literals;
+
+namespace pcat
+{
+	constexpr static auto cpuTopologyRoot{"/sys/devices/system/cpu"sv};
+
+	// Where a processor sits in the machine, as read from its topology directory in sysfs
+	struct processorTopology_t final
+	{
+		uint32_t cpu{};
+		uint32_t package{};
+		uint32_t core{};
+		// Which of its core's hardware threads this is, of those we may use, with 0 being the first
+		uint32_t thread{};
+		// Which of its package's cores this is, counting from 0 in order of core ID
+		uint32_t coreIndex{};
+	};
+
+	/*!
+	 * Works out which of its core's hardware threads each of the given processors is, and
+	 * which of its package's cores it is on, from their packages and cores. Only the given
+	 * processors are counted, so a core we may only use one thread of still gets one.
+	 */
+	inline void numberProcessors(std::vector<processorTopology_t> &processors)
+	{
+		// Go through the processors core by core, keeping each core's threads in CPU number order
+		std::vector<std::size_t> order(processors.size());
+		std::iota(order.begin(), order.end(), 0U);
+		std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b) noexcept
+		{
+			return std::make_pair(processors[a].package, processors[a].core) <
+				std::make_pair(processors[b].package, processors[b].core);
+		});
+		const processorTopology_t *previous{nullptr};
+		for (const auto index : order)
+		{
+			auto &processor{processors[index]};
+			if (!previous || previous->package != processor.package)
+			{
+				processor.thread = 0U;
+				processor.coreIndex = 0U;
+			}
+			else if (previous->core != processor.core)
+			{
+				processor.thread = 0U;
+				processor.coreIndex = previous->coreIndex + 1U;
+			}
+			else
+			{
+				processor.thread = previous->thread + 1U;
+				processor.coreIndex = previous->coreIndex;
+			}
+			previous = &processor;
+		}
+	}
+
+	/*!
+	 * Reads the topology of each processor from root (normally /sys/devices/system/cpu).
+	 * A processor whose topology can't be read is treated as a core of its own, so if none
+	 * of it can, every placement comes out the same as plain CPU number order.
+	 */
+	[[nodiscard]] inline std::vector<processorTopology_t> readProcessorTopology(const std::vector<uint32_t> &cpus,
+		const std::string_view root)
+	{
+		std::vector<processorTopology_t> processors{};
+		processors.reserve(cpus.size());
+		for (const auto cpu : cpus)
+		{
+			processorTopology_t processor{cpu, 0U, cpu, 0U, 0U};
+			const auto path{std::string{root} + "/cpu" + std::to_string(cpu) + "/topology/"};
+			// A single number is just a CPU list of one
+			const auto package{parseCPUList(readSysfsFile(path + "physical_package_id"))};
+			const auto core{parseCPUList(readSysfsFile(path + "core_id"))};
+			if (package.size() == 1U && core.size() == 1U)
+			{
+				processor.package = package[0];
+				processor.core = core[0];
+			}
+			processors.push_back(processor);
+		}
+		numberProcessors(processors);
+		return processors;
+	}
+
+	/*!
+	 * Orders the given processors (in CPU number order) by the requested placement, and
+	 * picks how many of them to use - limit if given, otherwise all of them, except for the
+	 * 'cores' placement which by default uses just one hardware thread per physical core so
+	 * no two copy threads have to share a core's load and store ports.
+	 */
+	[[nodiscard]] inline std::vector<uint32_t> placeProcessors(std::vector<processorTopology_t> processors,
+		const args::placement_t placement, const std::size_t limit)
+	{
+		numberProcessors(processors);
+		const auto order{[&](auto key)
+		{
+			std::stable_sort(processors.begin(), processors.end(),
+				[&](const processorTopology_t &a, const processorTopology_t &b) noexcept { return key(a) < key(b); });
+		}};
+
+		if (placement == args::placement_t::cores)
+			order([](const processorTopology_t &processor) noexcept { return processor.thread; });
+		else if (placement == args::placement_t::compact)
+			order([](const processorTopology_t &processor) noexcept
+				{ return std::make_tuple(processor.package, processor.core, processor.thread); });
+		else if (placement == args::placement_t::scatter)
+			order([](const processorTopology_t &processor) noexcept
+				{ return std::make_tuple(processor.thread, processor.coreIndex, processor.package); });
+
+		auto count{processors.size()};
+		if (limit)
+			count = std::min(count, limit);
+		else if (placement == args::placement_t::cores)
+			count = std::size_t(std::count_if(processors.begin(), processors.end(),
+				[](const processorTopology_t &processor) noexcept { return !processor.thread; }));
+
+		std::vector<uint32_t> result{};
+		result.reserve(count);
+		for (std::size_t i{}; i < count; ++i)
+			result.push_back(processors[i].cpu);
+		return result;
+	}
+
+	// As above, reading the topology of the given CPUs from root first
+	[[nodiscard]] inline std::vector<uint32_t> placeProcessors(const std::vector<uint32_t> &cpus,
+		const args::placement_t placement, const std::size_t limit, const std::string_view root = cpuTopologyRoot)
+		{ return placeProcessors(readProcessorTopology(cpus, root), placement, limit); }
+
+} // namespace pcat
+
+#endif /*PROCESSOR_PLACEMENT__HXX*/
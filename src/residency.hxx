@@ -0,0 +1,169 @@
+#ifndef RESIDENCY__HXX
+#define RESIDENCY__HXX
+
+#include <cstdint>
+#include <cerrno>
+#include <vector>
+#include <algorithm>
+#ifndef _WINDOWS
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#endif
+#include <substrate/fd>
+#include <substrate/units>
+#include "chunking.hxx"
+#include "mmap.hxx"
+
+namespace pcat
+{
+	using substrate::fd_t;
+	using substrate::off_t;
+	using substrate::operator ""_MiB;
+
+	// The most that gets read ahead for the cold parts of the inputs when planning a copy cached ranges first
+	constexpr static auto readaheadBudget{off_t(256_MiB)};
+
+	// cachestat(2) is new enough (Linux 6.5) that the C library headers may not know of it yet, in which case
+	// its number is only assumed where the architecture uses the generic syscall table. Those that offset
+	// their tables, such as alpha and the MIPS ABIs, go without unless the headers give the number
+#if defined(__linux__)
+#	if defined(SYS_cachestat)
+#		define PCAT_CACHESTAT SYS_cachestat
+#	elif defined(__NR_cachestat)
+#		define PCAT_CACHESTAT __NR_cachestat
+#	elif (defined(__x86_64__) && !defined(__ILP32__)) || defined(__i386__) || defined(__aarch64__) || \
+		defined(__arm__) || defined(__riscv) || defined(__powerpc__) || defined(__s390__) || defined(__loongarch__)
+#		define PCAT_CACHESTAT 451
+#	endif
+#endif
+
+#ifdef PCAT_CACHESTAT
+	namespace residency
+	{
+		constexpr static long cachestatSyscall{PCAT_CACHESTAT};
+
+		struct cachestatRange_t final
+		{
+			uint64_t offset;
+			uint64_t length;
+		};
+
+		struct cachestat_t final
+		{
+			uint64_t cached;
+			uint64_t dirty;
+			uint64_t writeback;
+			uint64_t evicted;
+			uint64_t recentlyEvicted;
+		};
+	} // namespace residency
+#endif
+
+	/*!
+	 * Works out how many bytes of length from offset into file are in the page cache,
+	 * giving -1 if that can't be found out. cachestat(2) is used where the kernel has it,
+	 * as it asks about the range without having to map it. Otherwise the range is mapped
+	 * and asked after page by page with mincore(), which doesn't fault any of it in.
+	 */
+	[[nodiscard]] inline off_t residentBytes(const fd_t &file, const off_t offset, const off_t length) noexcept
+	{
+#ifndef _WINDOWS
+		if (!file.valid() || length <= 0)
+			return -1;
+		const auto begin{(offset / pageSize) * pageSize};
+		const auto end{offset + length};
+		const auto pages{std::size_t((end - begin + pageSize - 1) / pageSize)};
+#ifdef PCAT_CACHESTAT
+		residency::cachestatRange_t range{uint64_t(begin), uint64_t(end - begin)};
+		residency::cachestat_t stat{};
+		if (syscall(residency::cachestatSyscall, int32_t{file}, &range, &stat, 0U) == 0)
+			return std::min(off_t(stat.cached) * pageSize, length);
+		else if (errno != ENOSYS)
+			return -1;
+#endif
+		mmap_t mapping{file, begin, end - begin, PROT_READ};
+		if (!mapping.valid())
+			return -1;
+		std::vector<unsigned char> state(pages);
+		if (mincore(mapping.address(0), std::size_t(end - begin), state.data()) != 0)
+			return -1;
+		const auto cached{std::count_if(state.begin(), state.end(), [](const unsigned char page) noexcept
+			{ return page & 1U; })};
+		return std::min(off_t(cached) * pageSize, length);
+#else
+		static_cast<void>(file);
+		static_cast<void>(offset);
+		static_cast<void>(length);
+		return -1;
+#endif
+	}
+
+	// Checks if at least half of the given range of the output is already cached in the inputs it comes from
+	[[nodiscard]] inline bool cachedRange(const off_t offset, const off_t length) noexcept
+	{
+		off_t cached{};
+		auto [file, inputOffset] = inputFiles.locate(offset);
+		for (off_t remaining{length}; remaining > 0 && file != inputFiles.end(); ++file, inputOffset = 0)
+		{
+			const auto amount{std::min(remaining, inputFiles.lengthOf(file) - inputOffset)};
+			if (const auto resident{residentBytes(*file, inputOffset, amount)}; resident > 0)
+				cached += resident;
+			remaining -= amount;
+		}
+		return cached * 2 >= length;
+	}
+
+	// Starts the kernel reading the head of the given range of the output in from the inputs it comes from
+	inline void readahead(const off_t offset, const off_t length) noexcept
+	{
+#ifndef _WINDOWS
+		auto [file, inputOffset] = inputFiles.locate(offset);
+		for (off_t remaining{length}; remaining > 0 && file != inputFiles.end(); ++file, inputOffset = 0)
+		{
+			const auto amount{std::min(remaining, inputFiles.lengthOf(file) - inputOffset)};
+			if (file->valid())
+				posix_fadvise(*file, inputOffset, amount, POSIX_FADV_WILLNEED);
+			remaining -= amount;
+		}
+#else
+		static_cast<void>(offset);
+		static_cast<void>(length);
+#endif
+	}
+
+	/*!
+	 * Reorders a plan of ranges of the output so those that are mostly in the page cache
+	 * come first, keeping the order within the cached and cold ranges otherwise as it was.
+	 * The head of each cold range is then read ahead, up to readaheadBudget in total, so
+	 * the first of them are on their way in by the time the cached ranges are copied.
+	 *
+	 * rangeOf gives the output offset and length of an entry in the plan. In lazy mode the
+	 * inputs aren't open yet, so there's nothing to ask and the plan is left as it is.
+	 */
+	template<typename range_t, typename rangeOf_t> void cachedFirst(std::vector<range_t> &plan, rangeOf_t rangeOf)
+	{
+		if (inputFiles.lazy())
+			return;
+		const auto cold
+		{
+			std::stable_partition(plan.begin(), plan.end(), [&](const range_t &range)
+			{
+				const auto [offset, length] = rangeOf(range);
+				return cachedRange(offset, length);
+			})
+		};
+
+		off_t budget{readaheadBudget};
+		for (auto range{cold}; range != plan.end() && budget > 0; ++range)
+		{
+			const auto [offset, length] = rangeOf(*range);
+			const auto amount{std::min({length, blockSize.current(), budget})};
+			readahead(offset, amount);
+			budget -= amount;
+		}
+	}
+} // namespace pcat
+
+#endif /*RESIDENCY__HXX*/
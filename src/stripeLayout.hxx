@@ -0,0 +1,141 @@
+#ifndef STRIPE_LAYOUT__HXX
+#define STRIPE_LAYOUT__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <numeric>
+#include <algorithm>
+#include <utility>
+#include <substrate/fd>
+#include <substrate/units>
+#ifndef _WINDOWS
+#	include <sys/xattr.h>
+#endif
+
+namespace pcat
+{
+	using substrate::fd_t;
+	using substrate::off_t;
+	using substrate::operator ""_GiB;
+
+	// The largest stripe size --stripe-size takes, as Lustre keeps stripe sizes in 32 bits
+	constexpr static auto maximumStripeSize{off_t(4_GiB)};
+
+	/*!
+	 * How the output is striped over the storage targets of a parallel filesystem such as
+	 * Lustre or GPFS, as the size of each stripe and how many targets they go round-robin
+	 * over. A block of the output that runs across a stripe boundary has to go to two
+	 * targets and waits on both, so with a layout set (by --stripe-size or --stripe-count)
+	 * blocks are cut to end on stripe boundaries, and consecutive spans of work start on
+	 * different targets so workers going through them side by side don't all queue on one.
+	 *
+	 * With no layout set, which is the default, nothing is changed.
+	 */
+	struct stripeLayout_t final
+	{
+	private:
+		off_t size_{0};
+		std::size_t count_{1};
+
+		// The layout header Lustre gives in the lustre.lov extended attribute, struct lov_user_md_v1/v3
+		constexpr static uint32_t lustreMagicV1{0x0BD10BD0U};
+		constexpr static uint32_t lustreMagicV3{0x0BD30BD0U};
+		constexpr static std::size_t lustreStripeSizeOffset{24U};
+		constexpr static std::size_t lustreStripeCountOffset{28U};
+		constexpr static std::size_t lustreHeaderLength{32U};
+
+		[[nodiscard]] off_t roundDown(const off_t offset) const noexcept { return (offset / size_) * size_; }
+
+	public:
+		constexpr stripeLayout_t() noexcept = default;
+		constexpr stripeLayout_t(const off_t size, const std::size_t count) noexcept :
+			size_{std::max<off_t>(size, 0)}, count_{std::max<std::size_t>(count, 1U)} { }
+
+		[[nodiscard]] bool enabled() const noexcept { return size_; }
+		[[nodiscard]] auto size() const noexcept { return size_; }
+		[[nodiscard]] auto count() const noexcept { return count_; }
+
+		/*!
+		 * Cuts a block of length bytes starting at offset in the output so it doesn't run part
+		 * way across a stripe boundary. A block that starts part way into a stripe is cut at the
+		 * end of that stripe, while one that starts on a boundary is cut to a whole number of
+		 * stripes, unless it is shorter than a stripe to begin with.
+		 */
+		[[nodiscard]] off_t trim(const off_t offset, const off_t length) const noexcept
+		{
+			if (!size_ || length <= 0)
+				return length;
+			const auto stripe{roundDown(offset)};
+			const auto end{offset + length};
+			if (end <= stripe + size_)
+				return length;
+			// Finishing off the stripe this starts part way into lines the blocks that follow up with stripes
+			if (offset != stripe)
+				return stripe + size_ - offset;
+			return roundDown(end) - offset;
+		}
+
+		/*!
+		 * Rounds the length of the spans of the output handed out to workers to the nearest whole
+		 * number of stripes, at least one, that shares no factor with the stripe count, going up
+		 * where both ways are as near. Spans laid end to end then each start one or more targets
+		 * on from the last, covering every target before two spans start on the same one. Going
+		 * up on a tie leaves a short last span over the output rather than an overlong one: 32
+		 * stripes for 4 workers over 4 targets are split 9, 9, 9 and 5 rather than 7, 7, 7 and 11.
+		 */
+		[[nodiscard]] off_t spanLength(const off_t length) const noexcept
+		{
+			if (!size_)
+				return length;
+			const auto stripes{std::max<off_t>(length / size_, 1)};
+			auto fewer{stripes};
+			while (fewer > 1 && std::gcd(fewer, off_t(count_)) != 1)
+				--fewer;
+			auto more{stripes};
+			while (std::gcd(more, off_t(count_)) != 1)
+				++more;
+			return (more - stripes <= stripes - fewer ? more : fewer) * size_;
+		}
+
+		// Reads the stripe layout out of the header of a Lustre lustre.lov extended attribute
+		[[nodiscard]] static stripeLayout_t fromLustre(const std::string_view layout) noexcept
+		{
+			if (layout.size() < lustreHeaderLength)
+				return {};
+			uint32_t magic{};
+			uint32_t size{};
+			uint16_t count{};
+			std::memcpy(&magic, layout.data(), sizeof(magic));
+			// Composite (progressive file layout) layouts vary the striping along the file so aren't handled here
+			if (magic != lustreMagicV1 && magic != lustreMagicV3)
+				return {};
+			std::memcpy(&size, layout.data() + lustreStripeSizeOffset, sizeof(size));
+			std::memcpy(&count, layout.data() + lustreStripeCountOffset, sizeof(count));
+			return {off_t(size), count};
+		}
+
+		// Asks Lustre how the file is striped, giving no layout if it isn't on Lustre
+		[[nodiscard]] static stripeLayout_t fromLustre(const fd_t &file)
+		{
+#ifndef _WINDOWS
+			const auto length{fgetxattr(file, "lustre.lov", nullptr, 0U)};
+			if (length <= 0)
+				return {};
+			std::string layout(std::size_t(length), '\0');
+			if (fgetxattr(file, "lustre.lov", layout.data(), layout.size()) != length)
+				return {};
+			return fromLustre(layout);
+#else
+			static_cast<void>(file);
+			return {};
+#endif
+		}
+	};
+
+	extern stripeLayout_t stripeLayout;
+} // namespace pcat
+
+#endif /*STRIPE_LAYOUT__HXX*/
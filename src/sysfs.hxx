@@ -0,0 +1,74 @@
+#ifndef SYSFS__HXX
+#define SYSFS__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifndef _WINDOWS
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+#include <substrate/fd>
+
+namespace pcat
+{
+	using substrate::fd_t;
+
+	// Reads one of the small text files sysfs, procfs and cgroupfs are made of, giving nothing if it can't be read
+	[[nodiscard]] inline std::string readSysfsFile(const std::string &path)
+	{
+		constexpr std::size_t maxLength{4096U};
+		const fd_t file{path.c_str(), O_RDONLY | O_NOCTTY};
+		if (!file.valid())
+			return {};
+		std::string contents(maxLength, '\0');
+		const auto result{read(file, contents.data(), contents.size())};
+		contents.resize(result > 0 ? std::size_t(result) : 0U);
+		return contents;
+	}
+
+	// Parses a kernel CPU list such as "0-3,8-11" into the CPUs it names, giving an empty list if it is malformed
+	[[nodiscard]] inline std::vector<uint32_t> parseCPUList(std::string_view list)
+	{
+		std::vector<uint32_t> cpus{};
+		const auto parseNumber{[](std::string_view &value, uint32_t &number) noexcept
+		{
+			std::size_t digits{};
+			number = 0;
+			while (digits < value.size() && value[digits] >= '0' && value[digits] <= '9')
+				number = (number * 10U) + uint32_t(value[digits++] - '0');
+			value.remove_prefix(digits);
+			return digits != 0;
+		}};
+
+		while (!list.empty() && list.back() == '\n')
+			list.remove_suffix(1);
+		while (!list.empty())
+		{
+			uint32_t first{};
+			uint32_t last{};
+			if (!parseNumber(list, first))
+				return {};
+			last = first;
+			if (!list.empty() && list.front() == '-')
+			{
+				list.remove_prefix(1);
+				if (!parseNumber(list, last) || last < first)
+					return {};
+			}
+			for (auto cpu{first}; cpu <= last; ++cpu)
+				cpus.push_back(cpu);
+			if (!list.empty())
+			{
+				if (list.front() != ',')
+					return {};
+				list.remove_prefix(1);
+			}
+		}
+		return cpus;
+	}
+} // namespace pcat
+
+#endif /*SYSFS__HXX*/
@@ -0,0 +1,132 @@
+#ifndef THREAD_GROUPS__HXX
+#define THREAD_GROUPS__HXX
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <substrate/utility>
+#include "args.hxx"
+#include "threadPool.hxx"
+#include "deviceGroups.hxx"
+#include "numaTopology.hxx"
+
+namespace pcat
+{
+	template<typename workFunc_t> struct threadGroups_t;
+
+	/*!
+	 * Runs a thread pool per device group, each pinned to its own run of the processors available.
+	 * As each pool has its own queue and its own cap on how many workers it may bring up, a device
+	 * that is slow to service its work only holds up the workers for that device.
+	 *
+	 * Where a group's device is attached to a NUMA node, its run of processors is taken from
+	 * that node's processors first, so the workers sit next to the device they copy from. The
+	 * groups whose devices aren't attached to a node are then given runs of the processors
+	 * those groups didn't claim, so they only double up on processors once all are in use.
+	 */
+	template<typename result_t, typename... args_t> struct threadGroups_t<result_t(args_t...)> final
+	{
+	private:
+		using workFunc_t = result_t (*)(args_t...);
+		using pool_t = threadPool_t<result_t(args_t...)>;
+		std::vector<std::unique_ptr<pool_t>> pools{};
+
+		// With --threads=auto, each group finds its own thread count as each has its own device to saturate
+		void controlThroughput()
+		{
+			if (!throughput::automatic())
+				return;
+			for (auto &pool : pools)
+				pool->controlThroughput();
+		}
+
+	public:
+		threadGroups_t(const workFunc_t function)
+		{
+			affinity_t affinity{};
+			if (deviceGroups.empty())
+			{
+				pools.emplace_back(substrate::make_unique<pool_t>(function, std::move(affinity)));
+				controlThroughput();
+				return;
+			}
+
+			const auto *const limit{dynamic_cast<args::argDeviceThreads_t *>(::args->find(argType_t::deviceThreads))};
+			deviceGroups.assignWorkers(affinity.numProcessors(), limit ? limit->count() : 0);
+			const numaTopology_t topology{};
+			// How far into the processors each node's groups have got, so groups on one node share them out
+			std::vector<std::size_t> nodeProcessors(topology.nodes());
+			// Groups attached to a node claim their runs first, as the rest can go anywhere
+			std::vector<affinity_t> slices{};
+			slices.reserve(deviceGroups.size());
+			std::vector<uint32_t> claimed{};
+			for (const auto &group : deviceGroups)
+			{
+#ifndef _WINDOWS
+				const auto node{group.node() != noNode ? topology.indexOf(std::size_t(group.node())) : topology.nodes()};
+				if (node < topology.nodes())
+				{
+					const auto &slice{slices.emplace_back(affinity, nodeProcessors[node], group.workers(),
+						[&](const auto processor) noexcept { return topology.nodeOf(processor) == node; })};
+					nodeProcessors[node] += group.workers();
+					claimed.insert(claimed.end(), slice.begin(), slice.end());
+					continue;
+				}
+#endif
+				slices.emplace_back(affinity, 0U, 0U);
+			}
+
+			// Then the rest, still empty, take theirs from the processors left unclaimed before any that were
+			std::size_t processor{};
+			for (std::size_t index{}; index < deviceGroups.size(); ++index)
+			{
+				const auto &group{deviceGroups[index]};
+				if (slices[index].numProcessors() != 0U)
+					continue;
+#ifndef _WINDOWS
+				slices[index] = affinity_t{affinity, processor, group.workers(), [&](const uint32_t candidate) noexcept
+					{ return std::find(claimed.begin(), claimed.end(), candidate) == claimed.end(); }};
+#else
+				slices[index] = affinity_t{affinity, processor, group.workers()};
+#endif
+				processor += group.workers();
+			}
+
+			for (auto &slice : slices)
+				pools.emplace_back(substrate::make_unique<pool_t>(function, std::move(slice)));
+			controlThroughput();
+		}
+
+		threadGroups_t(const threadGroups_t &) = delete;
+		threadGroups_t(threadGroups_t &&) = delete;
+		~threadGroups_t() noexcept = default;
+		threadGroups_t &operator =(const threadGroups_t &) = delete;
+		threadGroups_t &operator =(threadGroups_t &&) = delete;
+
+		[[nodiscard]] auto groups() const noexcept { return pools.size(); }
+		[[nodiscard]] std::size_t workers(const std::size_t group) const noexcept
+			{ return group < pools.size() ? pools[group]->numProcessors() : 0; }
+
+		[[nodiscard]] auto queue(const std::size_t group, args_t ...args)
+			{ return pools[group < pools.size() ? group : 0]->queue(std::forward<args_t>(args)...); }
+
+		[[nodiscard]] result_t finish()
+		{
+			result_t result{};
+			for (auto &pool : pools)
+			{
+				const auto poolResult{pool->finish()};
+				if (!result)
+					result = poolResult;
+			}
+			return result;
+		}
+	};
+
+	template<typename result_t, typename... args_t>
+		threadGroups_t(result_t (*)(args_t...)) -> threadGroups_t<result_t(args_t...)>;
+} // namespace pcat
+
+#endif /*THREAD_GROUPS__HXX*/
@@ -9,14 +9,16 @@
 #include <atomic>
 #include <tuple>
 #include <utility>
-#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <substrate/utility>
 #include "affinity.hxx"
+#include "latch.hxx"
 #include "threadedQueue.hxx"
+#include "throughputController.hxx"
 
 namespace pcat
 {
-	using namespace std::literals::chrono_literals;
-
 	template<typename workFunc_t> struct threadPool_t;
 
 	template<typename result_t, typename... args_t> struct threadPool_t<result_t(args_t...)> final
@@ -31,12 +33,16 @@ namespace pcat
 		threadedQueue_t<result_t> results{};
 		std::vector<std::thread> threads{};
 		affinity_t affinity{};
+		std::unique_ptr<throughputController_t> controller{};
 		workFunc_t workerFunction;
 
-		std::pair<bool, std::tuple<args_t...>> waitWork() noexcept
+		std::pair<bool, std::tuple<args_t...>> waitWork(latch_t *const started) noexcept
 		{
 			std::unique_lock<std::mutex> lock{workMutex};
 			++waitingThreads;
+			// If we were brought up as part of a batch, signal that we're now ready to take work
+			if (started)
+				started->countDown();
 			// wait, but protect ourselves from accidental wake-ups..
 			haveWork.wait(lock, [this]() noexcept -> bool { return finished || !work.empty(); });
 			--waitingThreads;
@@ -48,20 +54,55 @@ namespace pcat
 		template<std::size_t... indicies> auto invoke(std::tuple<args_t...> &&args,
 			std::index_sequence<indicies...>) { return workerFunction(std::get<indicies>(std::move(args))...); }
 
-		void workerThread(const std::size_t processor)
+		void workerThread(const std::size_t processor, latch_t *started)
 		{
 			affinity.pinThreadTo(processor);
 			while (!(finished && work.empty()))
 			{
-				auto [valid, args] = waitWork();
+				auto [valid, args] = waitWork(std::exchange(started, nullptr));
 				// This checks for both if we don't have something to do and if we're supposed to be finishing up
 				if (finished && !valid)
 					break;
+				// With a throughput controller, only run the work once the controller has room for us
+				auto *const control{controller.get()};
+				throughput::controller = control;
+				if (control)
+					control->enter();
 				auto result = invoke(std::move(args), std::make_index_sequence<sizeof...(args_t)>());
+				if (control)
+					control->leave();
+				throughput::controller = nullptr;
 				results.push(std::move(result));
 			}
 		}
 
+		void spawnWorker(latch_t *const started = nullptr)
+		{
+			threads.emplace_back(std::thread{[this, started](const auto processor) -> void
+				{ workerThread(processor, started); }, threads.size()});
+		}
+
+		// Brings up count workers at once, only returning once they are all waiting for work
+		void spawnWorkers(const std::size_t count)
+		{
+			if (!count)
+				return;
+			latch_t started{count};
+			for (std::size_t i{}; i < count; ++i)
+				spawnWorker(&started);
+			started.wait();
+		}
+
+		void notifyWork(const bool all = false) noexcept
+		{
+			// Synchronise with any worker that's between checking for work and going to sleep
+			{ std::lock_guard<std::mutex> lock{workMutex}; }
+			if (all)
+				haveWork.notify_all();
+			else
+				haveWork.notify_one();
+		}
+
 		auto clearResultQueue()
 		{
 			result_t result{};
@@ -75,14 +116,17 @@ namespace pcat
 		}
 
 	public:
-		threadPool_t(const workFunc_t function) : workerFunction{function}
-		{
-			for (const auto processor : affinity.indexSequence())
-				threads.emplace_back(std::thread{[this](const auto processor) -> void
-					{ workerThread(processor); }, processor});
-			while (!ready())
-				std::this_thread::sleep_for(1us);
-		}
+		/*!
+		 * Workers are brought up lazily as work is queued, so a pool only ever has as many threads
+		 * as it has had work items to run at once, up to the number of processors available.
+		 * If the caller knows how many workers it will need up front, it can ask for them to be
+		 * brought up together via the workers parameter.
+		 */
+		threadPool_t(const workFunc_t function, const std::size_t workers = 0) : workerFunction{function}
+			{ spawnWorkers(std::min(workers, affinity.numProcessors())); }
+		threadPool_t(const workFunc_t function, affinity_t &&processors, const std::size_t workers = 0) :
+			affinity{std::move(processors)}, workerFunction{function}
+			{ spawnWorkers(std::min(workers, affinity.numProcessors())); }
 		threadPool_t(const threadPool_t &) = delete;
 		threadPool_t(threadPool_t &&) = delete;
 		~threadPool_t() noexcept { [[maybe_unused]] const auto result = finish(); }
@@ -90,31 +134,60 @@ namespace pcat
 		threadPool_t &operator =(threadPool_t &&) = delete;
 
 		[[nodiscard]] auto numProcessors() const noexcept { return affinity.numProcessors(); }
-		[[nodiscard]] auto valid() const noexcept { return !threads.empty(); }
-		[[nodiscard]] auto ready() const noexcept { return waitingThreads == affinity.numProcessors(); }
+		[[nodiscard]] auto numWorkers() const noexcept { return threads.size(); }
+		[[nodiscard]] auto valid() const noexcept { return !finished; }
+		[[nodiscard]] auto ready() const noexcept { return waitingThreads == threads.size(); }
+		// How many of the workers may run at once, which is all of them unless a throughput controller says otherwise
+		[[nodiscard]] std::size_t activeWorkers() const noexcept
+			{ return controller ? controller->active() : affinity.numProcessors(); }
+
+		/*!
+		 * Hands how many of the workers run at once over to a throughput controller, for
+		 * --threads=auto. This must be done before any work is queued, and the work must
+		 * report the bytes it copies and mark where it may be parked through the functions
+		 * in the throughput namespace.
+		 */
+		void controlThroughput()
+		{
+			if (controller)
+				return;
+			controller = substrate::make_unique<throughputController_t>(affinity.numProcessors());
+			controller->start();
+		}
 
 		[[nodiscard]] auto queue(args_t ...args)
 		{
 			work.emplace(std::forward<args_t>(args)...);
-			haveWork.notify_one();
+			// Only bring up a new worker if there's more work queued than idle workers to take it
+			if (threads.size() < affinity.numProcessors() && work.size() > waitingThreads)
+				spawnWorker();
+			notifyWork();
 			return clearResultQueue();
 		}
 
 		[[nodiscard]] result_t finish()
 		{
-			if (threads.empty())
+			if (finished)
 				return {};
 			finished = true;
-			haveWork.notify_all();
+			notifyWork(true);
 			for (auto &thread : threads)
 				thread.join();
 			threads.clear();
+			if (controller)
+				controller->stop();
 			return clearResultQueue();
 		}
 	};
 
 	template<typename result_t, typename... args_t>
 		threadPool_t(result_t (*)(args_t...)) -> threadPool_t<result_t(args_t...)>;
+	template<typename result_t, typename... args_t>
+		threadPool_t(result_t (*)(args_t...), std::size_t) -> threadPool_t<result_t(args_t...)>;
+	template<typename result_t, typename... args_t>
+		threadPool_t(result_t (*)(args_t...), affinity_t &&) -> threadPool_t<result_t(args_t...)>;
+	template<typename result_t, typename... args_t>
+		threadPool_t(result_t (*)(args_t...), affinity_t &&, std::size_t) -> threadPool_t<result_t(args_t...)>;
 } // namespace pcat
 
 #endif /*THREAD_POOL__HXX*/
@@ -0,0 +1,227 @@
+#ifndef THROUGHPUT_CONTROLLER__HXX
+#define THROUGHPUT_CONTROLLER__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include "args.hxx"
+
+namespace pcat
+{
+	using namespace std::literals::chrono_literals;
+
+	/*!
+	 * Picks how many of a thread pool's workers should be copying at once, for --threads=auto,
+	 * by watching how many bytes per second they get through together. It starts with a
+	 * few workers and climbs a worker at a time while each extra worker pays for itself,
+	 * stepping back and settling once one doesn't. Every so often while settled it probes
+	 * a worker either side of where it is, in case the storage has got more or less busy.
+	 *
+	 * The workers past the current limit are parked on a condition variable between
+	 * pieces of work, so cost nothing until the limit next goes up. This works as a
+	 * counting semaphore, so whichever workers get there first are the ones that run.
+	 */
+	struct throughputController_t final
+	{
+	public:
+		// How long each measurement of the throughput runs for
+		constexpr static auto window{250ms};
+		// How much the throughput has to move by between windows to count as a change
+		constexpr static double tolerance{0.05};
+		// How many windows to sit settled for before probing either side again
+		constexpr static std::size_t probeWindows{8U};
+		constexpr static std::size_t initialWorkers{2U};
+
+	private:
+		std::size_t maximum_;
+		std::atomic<std::size_t> active_;
+		std::size_t running{0};
+		// Shared so bytes finished off by the nowait engine's slow path can still be counted once we're gone
+		std::shared_ptr<std::atomic<uint64_t>> bytes{std::make_shared<std::atomic<uint64_t>>(0U)};
+		std::mutex stateMutex{};
+		std::condition_variable stateChanged{};
+		std::condition_variable stopping{};
+		bool finished{false};
+		std::thread controller{};
+
+		// Hill climbing state
+		double lastRate{0.0};
+		bool measured{false};
+		bool settling{false};
+		int32_t direction{1};
+		int32_t lastStep{0};
+		std::size_t plateauWindows{0};
+
+		void move(const int32_t step) noexcept
+		{
+			const std::size_t active{active_};
+			// Turn around at either end of the range rather than getting stuck pushing against it
+			if ((step > 0 && active >= maximum_) || (step < 0 && active <= 1U))
+			{
+				direction = -step;
+				return;
+			}
+			active_ = step > 0 ? active + 1U : active - 1U;
+			lastStep = step;
+			plateauWindows = 0;
+		}
+
+		void control()
+		{
+			using clock_t = std::chrono::steady_clock;
+			std::unique_lock<std::mutex> lock{stateMutex};
+			auto begin{clock_t::now()};
+			while (!stopping.wait_for(lock, window, [this]() noexcept { return finished; }))
+			{
+				const auto end{clock_t::now()};
+				const std::chrono::duration<double> elapsed{end - begin};
+				begin = end;
+				const std::size_t previous{active_};
+				if (adjust(double(bytes->exchange(0)) / elapsed.count()) > previous)
+					stateChanged.notify_all();
+			}
+		}
+
+	public:
+		throughputController_t(const std::size_t maximum) noexcept :
+			maximum_{std::max<std::size_t>(maximum, 1U)}, active_{std::min(initialWorkers, maximum_)} { }
+		throughputController_t(const throughputController_t &) = delete;
+		throughputController_t(throughputController_t &&) = delete;
+		~throughputController_t() noexcept { stop(); }
+		throughputController_t &operator =(const throughputController_t &) = delete;
+		throughputController_t &operator =(throughputController_t &&) = delete;
+
+		[[nodiscard]] auto maximum() const noexcept { return maximum_; }
+		[[nodiscard]] std::size_t active() const noexcept { return active_; }
+
+		/*!
+		 * Takes one measurement of the throughput, in bytes per second, and decides how many
+		 * workers should run for the next window, returning that count. A step up is kept only
+		 * if it bought more throughput, while a step down is kept so long as it cost none, so
+		 * the count settles on the fewest workers that give the best throughput.
+		 */
+		std::size_t adjust(const double rate) noexcept
+		{
+			const auto previous{std::exchange(lastRate, rate)};
+			const auto step{std::exchange(lastStep, 0)};
+			// The first window, and the one after stepping back, just give a baseline to compare against
+			if (!std::exchange(measured, true))
+			{
+				move(direction);
+				return active_;
+			}
+			if (std::exchange(settling, false))
+				return active_;
+
+			const auto gained{rate > previous * (1.0 + tolerance)};
+			const auto lost{rate < previous * (1.0 - tolerance)};
+			if (step)
+			{
+				if (step > 0 ? gained : !lost)
+					move(step);
+				else
+				{
+					// That step didn't pay for itself, so undo it and settle here
+					move(-step);
+					lastStep = 0;
+					direction = -step;
+					settling = true;
+				}
+			}
+			// If the throughput has changed under us, something else has, so go looking for the best count again
+			else if (gained || lost || ++plateauWindows >= probeWindows)
+				move(direction);
+			return active_;
+		}
+
+		// Starts measuring the throughput and adjusting the worker count every window
+		void start() { controller = std::thread{[this]() { control(); }}; }
+
+		// Stops adjusting the worker count and lets every parked worker run
+		void stop() noexcept
+		{
+			{
+				std::lock_guard<std::mutex> lock{stateMutex};
+				finished = true;
+			}
+			stateChanged.notify_all();
+			stopping.notify_all();
+			if (controller.joinable())
+				controller.join();
+		}
+
+		void transferred(const uint64_t amount) noexcept { bytes->fetch_add(amount, std::memory_order_relaxed); }
+		// Gets the count of bytes transferred, for work that finishes on threads outside the pool
+		[[nodiscard]] const auto &counter() const noexcept { return bytes; }
+
+		// Waits for this worker to be allowed to run
+		void enter()
+		{
+			std::unique_lock<std::mutex> lock{stateMutex};
+			stateChanged.wait(lock, [this]() noexcept { return finished || running < active_; });
+			++running;
+		}
+
+		// Gives up this worker's place, letting a parked worker run in its stead
+		void leave()
+		{
+			{
+				std::lock_guard<std::mutex> lock{stateMutex};
+				--running;
+			}
+			stateChanged.notify_one();
+		}
+
+		// Parks the calling worker if there are more workers running than the current limit
+		void pace()
+		{
+			{
+				std::lock_guard<std::mutex> lock{stateMutex};
+				if (finished || running <= active_)
+					return;
+			}
+			leave();
+			enter();
+		}
+	};
+
+	namespace throughput
+	{
+		// Checks if the number of copy threads has been left to the throughput controller with --threads=auto
+		[[nodiscard]] inline bool automatic() noexcept
+		{
+			const auto *const threadCount{dynamic_cast<args::argThreads_t *>(::args->find(argType_t::threads))};
+			return threadCount && threadCount->automatic();
+		}
+
+		// The controller for the pool the calling thread is a worker of, if the pool has one
+		inline thread_local throughputController_t *controller{nullptr};
+
+		// Counts bytes copied by the calling worker towards its pool's throughput
+		inline void transferred(const uint64_t amount) noexcept
+		{
+			if (controller)
+				controller->transferred(amount);
+		}
+
+		// Gets the calling worker's pool's count of bytes transferred, if the pool has a controller
+		[[nodiscard]] inline std::shared_ptr<std::atomic<uint64_t>> counter() noexcept
+			{ return controller ? controller->counter() : nullptr; }
+
+		// Marks a point between pieces of work where the calling worker may be parked
+		inline void pace()
+		{
+			if (controller)
+				controller->pace();
+		}
+	} // namespace throughput
+} // namespace pcat
+
+#endif /*THROUGHPUT_CONTROLLER__HXX*/
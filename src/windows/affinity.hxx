@@ -64,6 +64,7 @@ namespace pcat
 		{
 			const auto *const pinning{dynamic_cast<args::argPinning_t *>(::args->find(argType_t::pinning))};
 			const auto *const threadCount{dynamic_cast<args::argThreads_t *>(::args->find(argType_t::threads))};
+			const std::size_t limit{threadCount ? threadCount->threads() : 0U};
 			const auto processorInfo{retrieveProcessorInfo()};
 			size_t count{};
 
@@ -79,7 +80,7 @@ namespace pcat
 					{
 						if (mask & 1)
 						{
-							if ((!threadCount || processors.size() < threadCount->threads()) &&
+							if ((!limit || processors.size() < limit) &&
 								(!pinning || std::find(pinning->begin(), pinning->end(), count) != pinning->end()))
 								processors.emplace_back(groupIndex, i);
 							++count;
@@ -92,6 +93,14 @@ namespace pcat
 			}
 		}
 
+		// Builds an affinity over a run of another's processors, wrapping around if it runs out
+		affinity_t(const affinity_t &affinity, const std::size_t begin, const std::size_t count)
+		{
+			const auto total{affinity.processors.size()};
+			for (std::size_t i{}; total && i < count; ++i)
+				processors.push_back(affinity.processors[(begin + i) % total]);
+		}
+
 		[[nodiscard]] auto numProcessors() const noexcept { return processors.size(); }
 		[[nodiscard]] auto begin() const noexcept { return processors.begin(); }
 		[[nodiscard]] auto end() const noexcept { return processors.end(); }
@@ -0,0 +1,313 @@
+#ifndef WORKLOAD_POLICY__HXX
+#define WORKLOAD_POLICY__HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <sys/types.h>
+#ifdef __linux__
+#	include <sys/vfs.h>
+#endif
+#include <substrate/fd>
+#include <substrate/units>
+#include "args.hxx"
+#include "residency.hxx"
+
+namespace pcat
+{
+	using namespace std::literals::string_view_literals;
+	using substrate::fd_t;
+	using substrate::off_t;
+	using substrate::operator ""_GiB;
+	using args::algorithm_t;
+	using args::schedule_t;
+	using args::engine_t;
+
+	// The output length from which --algorithm=auto tunes the block size as the copy runs
+	constexpr static auto largeOutputLength{off_t(1_GiB)};
+	// The most inputs --algorithm=auto checks the page cache residency of
+	constexpr static std::size_t residencySamples{64U};
+
+	// The kinds of filesystem --algorithm=auto tells apart
+	enum class filesystem_t : uint8_t
+	{
+		other,
+		ext4,
+		xfs,
+		tmpfs,
+		nfs,
+		lustre,
+		gpfs
+	};
+
+	namespace filesystem
+	{
+		// The f_type statfs() gives for each filesystem, as not every one is in linux/magic.h
+		constexpr static uint32_t ext4Magic{0x0000EF53U};
+		constexpr static uint32_t xfsMagic{0x58465342U};
+		constexpr static uint32_t tmpfsMagic{0x01021994U};
+		constexpr static uint32_t nfsMagic{0x00006969U};
+		constexpr static uint32_t lustreMagic{0x0BD00BD0U};
+		constexpr static uint32_t gpfsMagic{0x47504653U};
+
+		[[nodiscard]] constexpr inline filesystem_t fromMagic(const uint32_t magic) noexcept
+		{
+			switch (magic)
+			{
+				case ext4Magic:
+					return filesystem_t::ext4;
+				case xfsMagic:
+					return filesystem_t::xfs;
+				case tmpfsMagic:
+					return filesystem_t::tmpfs;
+				case nfsMagic:
+					return filesystem_t::nfs;
+				case lustreMagic:
+					return filesystem_t::lustre;
+				case gpfsMagic:
+					return filesystem_t::gpfs;
+				default:
+					return filesystem_t::other;
+			}
+		}
+
+		[[nodiscard]] constexpr inline std::string_view nameOf(const filesystem_t filesystem) noexcept
+		{
+			switch (filesystem)
+			{
+				case filesystem_t::ext4:
+					return "ext4"sv;
+				case filesystem_t::xfs:
+					return "XFS"sv;
+				case filesystem_t::tmpfs:
+					return "tmpfs"sv;
+				case filesystem_t::nfs:
+					return "NFS"sv;
+				case filesystem_t::lustre:
+					return "Lustre"sv;
+				case filesystem_t::gpfs:
+					return "GPFS"sv;
+				default:
+					return "another filesystem"sv;
+			}
+		}
+
+		// Checks if the filesystem is a parallel one that stripes files over many storage targets
+		[[nodiscard]] constexpr inline bool parallel(const filesystem_t filesystem) noexcept
+			{ return filesystem == filesystem_t::lustre || filesystem == filesystem_t::gpfs; }
+
+		// Finds out which kind of filesystem the file is on
+		[[nodiscard]] inline filesystem_t of(const fd_t &file) noexcept
+		{
+#ifdef __linux__
+			struct statfs fileSystem{};
+			if (!file.valid() || fstatfs(file, &fileSystem) != 0)
+				return filesystem_t::other;
+			return fromMagic(static_cast<uint32_t>(fileSystem.f_type));
+#else
+			static_cast<void>(file);
+			return filesystem_t::other;
+#endif
+		}
+
+		// Finds out which kind of filesystem the file at path is on, for inputs added in lazy mode
+		[[nodiscard]] inline filesystem_t of(const std::string &path) noexcept
+		{
+#ifdef __linux__
+			struct statfs fileSystem{};
+			if (statfs(path.c_str(), &fileSystem) != 0)
+				return filesystem_t::other;
+			return fromMagic(static_cast<uint32_t>(fileSystem.f_type));
+#else
+			static_cast<void>(path);
+			return filesystem_t::other;
+#endif
+		}
+	} // namespace filesystem
+
+	// What --algorithm=auto knows of the copy when picking how to do it
+	struct workloadProfile_t final
+	{
+		std::size_t files{0};
+		off_t totalLength{0};
+		off_t medianLength{0};
+		off_t largestLength{0};
+		std::size_t processors{1};
+		filesystem_t output{filesystem_t::other};
+		// The filesystem the most input bytes are on
+		filesystem_t inputs{filesystem_t::other};
+		// Whether any of the inputs are on the same device as the output
+		bool sharedDevice{false};
+		// How many of the inputs sampled were mostly in the page cache, and how many weren't
+		std::size_t cachedInputs{0};
+		std::size_t coldInputs{0};
+	};
+
+	// How --algorithm=auto has decided the copy should be done, and why
+	struct workloadPolicy_t final
+	{
+		algorithm_t algorithm{algorithm_t::blockLinear};
+		schedule_t schedule{schedule_t::staticSpans};
+		engine_t engine{engine_t::mmap};
+		bool alignStripes{false};
+		bool tuneBlockSize{false};
+		bool tuneThreads{false};
+		std::vector<std::string_view> reasons{};
+	};
+
+	/*!
+	 * Profiles the copy from the inputs to output for --algorithm=auto: how many inputs there
+	 * are and how their sizes are spread, which filesystems the output and inputs are on, and
+	 * whether any input shares the output's device. The filesystem is asked once per input
+	 * device. Unless in lazy mode, a sample of the inputs spread across the list are also
+	 * checked for how much of each is already in the page cache.
+	 */
+	[[nodiscard]] inline workloadProfile_t profileWorkload(const fd_t &output, const std::size_t processors)
+	{
+		workloadProfile_t profile{};
+		profile.files = inputFiles.size();
+		profile.totalLength = inputFiles.totalLength();
+		profile.processors = std::max<std::size_t>(processors, 1U);
+		profile.output = filesystem::of(output);
+		if (inputFiles.empty())
+			return profile;
+
+		std::vector<off_t> lengths{};
+		lengths.reserve(inputFiles.size());
+		const auto outputDevice{inputMetadata_t::of(output).device};
+		std::vector<std::pair<dev_t, filesystem_t>> devices{};
+		std::array<off_t, std::size_t(filesystem_t::gpfs) + 1U> bytes{};
+		for (std::size_t index{}; index < inputFiles.size(); ++index)
+		{
+			const auto length{inputFiles.lengthOf(index)};
+			lengths.push_back(length);
+			const auto device{inputFiles.deviceOf(index)};
+			profile.sharedDevice |= device == outputDevice;
+			auto known
+			{
+				std::find_if(devices.begin(), devices.end(), [&](const std::pair<dev_t, filesystem_t> &entry) noexcept
+					{ return entry.first == device; })
+			};
+			if (known == devices.end())
+			{
+				const auto filesystem
+				{
+					inputFiles.lazy() ? filesystem::of(inputFiles.pathOf(index)) : filesystem::of(inputFiles[index])
+				};
+				known = devices.emplace(devices.end(), device, filesystem);
+			}
+			bytes[std::size_t(known->second)] += length;
+		}
+		profile.inputs = filesystem_t(std::max_element(bytes.begin(), bytes.end()) - bytes.begin());
+
+		const auto median{lengths.begin() + std::ptrdiff_t(lengths.size() / 2U)};
+		std::nth_element(lengths.begin(), median, lengths.end());
+		profile.medianLength = *median;
+		profile.largestLength = *std::max_element(lengths.begin(), lengths.end());
+
+		// Lazily opened inputs aren't open yet, so there's nothing to ask the page cache about
+		if (inputFiles.lazy())
+			return profile;
+		const auto stride{std::max<std::size_t>(inputFiles.size() / residencySamples, 1U)};
+		for (std::size_t index{}; index < inputFiles.size(); index += stride)
+		{
+			const auto length{inputFiles.lengthOf(index)};
+			const auto resident{residentBytes(inputFiles[index], 0, length)};
+			if (resident < 0)
+				continue;
+			if (resident * 2 >= length)
+				++profile.cachedInputs;
+			else
+				++profile.coldInputs;
+		}
+		return profile;
+	}
+
+	/*!
+	 * Picks the algorithm, and the engine, schedule, block size and thread count settings to
+	 * go with it, for --algorithm=auto from a profile of the copy, noting the reason for each
+	 * choice. Settings that aren't picked are left at their defaults.
+	 *
+	 * A copy entirely in memory is bound by memory bandwidth so gets the defaults. Otherwise
+	 * the algorithm is picked by, in order: outputs too short for a span per thread and
+	 * inputs mostly smaller than a block go to blockLinear, parallel filesystems get guided
+	 * chunkSpans aligned to the stripes, and inputs all on different devices to the output
+	 * get the pipeline, whatever filesystems they are. Anything else is copied with blockLinear.
+	 */
+	[[nodiscard]] inline workloadPolicy_t choosePolicy(const workloadProfile_t &profile)
+	{
+		workloadPolicy_t policy{};
+		if (profile.output == filesystem_t::tmpfs && profile.inputs == filesystem_t::tmpfs)
+		{
+			policy.reasons.push_back("The inputs and output are all in memory (tmpfs), "
+				"so the copy is bound by memory bandwidth and the defaults do best"sv);
+			return policy;
+		}
+
+		const auto inMemory{profile.output == filesystem_t::tmpfs || profile.inputs == filesystem_t::tmpfs};
+		const auto parallel{filesystem::parallel(profile.output) || filesystem::parallel(profile.inputs)};
+		const auto network{profile.output == filesystem_t::nfs || profile.inputs == filesystem_t::nfs};
+		const auto shortOutput{profile.totalLength <= transferBlockSize * off_t(profile.processors)};
+		const auto smallInputs{profile.files > profile.processors && profile.medianLength < transferBlockSize};
+
+		if (shortOutput)
+			policy.reasons.push_back("The output is too short to give each thread a span of it, "
+				"so it is copied a block at a time with blockLinear"sv);
+		else if (smallInputs)
+			policy.reasons.push_back("Most inputs are smaller than a block, "
+				"so each is queued whole in turn with blockLinear"sv);
+		else if (parallel)
+		{
+			policy.algorithm = algorithm_t::chunkSpans;
+			policy.schedule = schedule_t::guidedSpans;
+			policy.alignStripes = true;
+			policy.tuneBlockSize = true;
+			policy.reasons.push_back("The storage is a parallel filesystem (Lustre or GPFS), so threads are "
+				"handed guided chunkSpans spans lined up with its stripes, with the block size tuned to it"sv);
+		}
+		else if (!profile.sharedDevice && !inMemory)
+		{
+			policy.algorithm = algorithm_t::pipeline;
+			policy.reasons.push_back("The inputs are on different devices to the output, "
+				"so reading and writing are overlapped with pipeline"sv);
+		}
+		else
+			policy.reasons.push_back("The inputs are large and local, which blockLinear handles well"sv);
+
+		if (policy.algorithm != algorithm_t::pipeline && profile.cachedInputs && profile.coldInputs)
+		{
+			policy.engine = engine_t::nowait;
+			policy.reasons.push_back("Some inputs are already in the page cache and some aren't, "
+				"so the nowait engine copies cached data without waiting on the rest"sv);
+		}
+
+		if (network)
+		{
+			policy.tuneThreads = true;
+			policy.reasons.push_back("The storage is shared over the network (NFS), "
+				"so how many threads copy at once is tuned to the throughput seen"sv);
+		}
+		// A parallel filesystem is one device as far as the kernel's concerned, but spreads over many targets
+		else if (profile.sharedDevice && !inMemory && !parallel)
+		{
+			policy.tuneThreads = true;
+			policy.reasons.push_back("Inputs share a device with the output, so reading and writing contend and "
+				"how many threads copy at once is tuned to the throughput seen"sv);
+		}
+
+		if (!policy.tuneBlockSize && !shortOutput && !smallInputs && !inMemory &&
+			profile.totalLength >= largeOutputLength)
+		{
+			policy.tuneBlockSize = true;
+			policy.reasons.push_back("The output is large, so the block size is tuned as the copy runs"sv);
+		}
+		return policy;
+	}
+} // namespace pcat
+
+#endif /*WORKLOAD_POLICY__HXX*/
@@ -0,0 +1,103 @@
+#include "testBlockCursor.hxx"
+
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
+
+using pcat::algorithm::blockLinear::blockCursor_t;
+using pcat::mappingOffset_t;
+using pcat::transferBlockSize;
+using pcat::off_t;
+
+constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
+
+namespace blockCursor
+{
+	void assertBlock(testsuite &suite, const mappingOffset_t &block, const off_t offset, const off_t length)
+	{
+		suite.assertEqual(block.offset(), offset);
+		suite.assertEqual(block.length(), length);
+	}
+
+	void testEmpty(testsuite &suite)
+	{
+		blockCursor_t cursor{};
+		suite.assertTrue(cursor.empty());
+		suite.assertEqual(cursor.blocks(), 0_uz);
+		suite.assertEqual(cursor.next().length(), 0);
+		cursor.addRange(1024, 0);
+		suite.assertTrue(cursor.empty());
+	}
+
+	void testSingleRange(testsuite &suite)
+	{
+		blockCursor_t cursor{};
+		cursor.addRange(0, (transferBlockSize * 2) + 4096);
+		suite.assertFalse(cursor.empty());
+		suite.assertEqual(cursor.blocks(), 3_uz);
+		assertBlock(suite, cursor.next(), 0, transferBlockSize);
+		assertBlock(suite, cursor.next(), transferBlockSize, transferBlockSize);
+		assertBlock(suite, cursor.next(), transferBlockSize * 2, 4096);
+		suite.assertEqual(cursor.next().length(), 0);
+		suite.assertEqual(cursor.next().length(), 0);
+	}
+
+	void testMergeRanges(testsuite &suite)
+	{
+		blockCursor_t cursor{};
+		// Contiguous ranges must behave as one so blocks stay aligned to the output
+		cursor.addRange(0, 1024);
+		cursor.addRange(1024, transferBlockSize);
+		suite.assertEqual(cursor.blocks(), 2_uz);
+		assertBlock(suite, cursor.next(), 0, transferBlockSize);
+		assertBlock(suite, cursor.next(), transferBlockSize, 1024);
+		suite.assertEqual(cursor.next().length(), 0);
+	}
+
+	void testSplitRanges(testsuite &suite)
+	{
+		blockCursor_t cursor{};
+		cursor.addRange(1024, transferBlockSize + 2048);
+		cursor.addRange((transferBlockSize * 4) + 512, 512);
+		suite.assertEqual(cursor.blocks(), 3_uz);
+		// Blocks must never run from one range into the next
+		assertBlock(suite, cursor.next(), 1024, transferBlockSize);
+		assertBlock(suite, cursor.next(), transferBlockSize + 1024, 2048);
+		assertBlock(suite, cursor.next(), (transferBlockSize * 4) + 512, 512);
+		suite.assertEqual(cursor.next().length(), 0);
+	}
+
+	void testResizeBlocks(testsuite &suite)
+	{
+		blockCursor_t cursor{};
+		cursor.addRange(0, transferBlockSize * 4);
+		assertBlock(suite, cursor.next(), 0, transferBlockSize);
+		// A change of block size part way through takes effect from the next block on
+		pcat::blockSize.fixed(transferBlockSize * 2);
+		assertBlock(suite, cursor.next(), transferBlockSize, transferBlockSize * 2);
+		pcat::blockSize.fixed(transferBlockSize / 2);
+		assertBlock(suite, cursor.next(), transferBlockSize * 3, transferBlockSize / 2);
+		assertBlock(suite, cursor.next(), (transferBlockSize * 7) / 2, transferBlockSize / 2);
+		suite.assertEqual(cursor.next().length(), 0);
+		pcat::blockSize.fixed(transferBlockSize);
+	}
+
+	void testStripeAligned(testsuite &suite)
+	{
+		blockCursor_t cursor{};
+		// Two ranges that don't start on stripe boundaries, the second running over several stripes
+		cursor.addRange(1024, transferBlockSize);
+		cursor.addRange((transferBlockSize * 4) + 512, (transferBlockSize * 2) + 1024);
+		pcat::stripeLayout = {transferBlockSize / 2, 4U};
+		// The first block of each range is cut at the end of the stripe it starts in
+		assertBlock(suite, cursor.next(), 1024, (transferBlockSize / 2) - 1024);
+		assertBlock(suite, cursor.next(), transferBlockSize / 2, transferBlockSize / 2);
+		assertBlock(suite, cursor.next(), transferBlockSize, 1024);
+		assertBlock(suite, cursor.next(), (transferBlockSize * 4) + 512, (transferBlockSize / 2) - 512);
+		// After which every block lines up with the stripes
+		assertBlock(suite, cursor.next(), (transferBlockSize * 9) / 2, transferBlockSize);
+		assertBlock(suite, cursor.next(), (transferBlockSize * 11) / 2, transferBlockSize / 2);
+		assertBlock(suite, cursor.next(), transferBlockSize * 6, 1536);
+		suite.assertEqual(cursor.next().length(), 0);
+		pcat::stripeLayout = {};
+	}
+} // namespace blockCursor
@@ -1,7 +1,7 @@
 #include <substrate/utility>
 #include "testChunkState.hxx"
 
-std::vector<substrate::fd_t> pcat::inputFiles{};
+pcat::inputFiles_t pcat::inputFiles{};
 
 using pcat::algorithm::blockLinear::chunkState_t;
 using pcat::mappingOffset_t;
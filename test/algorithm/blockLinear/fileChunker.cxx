@@ -1,8 +1,10 @@
 #include <substrate/utility>
 #include "testFileChunker.hxx"
 
-std::vector<substrate::fd_t> pcat::inputFiles{};
+pcat::inputFiles_t pcat::inputFiles{};
 substrate::fd_t pcat::outputFile{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
 
 using pcat::algorithm::blockLinear::fileChunker_t;
 using pcat::algorithm::blockLinear::chunking_t;
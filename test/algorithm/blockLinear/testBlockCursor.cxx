@@ -0,0 +1,32 @@
+#include "testBlockCursor.hxx"
+
+class testBlockCursor final : public testsuite
+{
+private:
+	void testEmpty() { blockCursor::testEmpty(*this); }
+	void testSingleRange() { blockCursor::testSingleRange(*this); }
+	void testMergeRanges() { blockCursor::testMergeRanges(*this); }
+	void testSplitRanges() { blockCursor::testSplitRanges(*this); }
+	void testResizeBlocks() { blockCursor::testResizeBlocks(*this); }
+	void testStripeAligned() { blockCursor::testStripeAligned(*this); }
+
+public:
+	testBlockCursor() = default;
+	testBlockCursor(const testBlockCursor &) = delete;
+	testBlockCursor(testBlockCursor &&) = delete;
+	testBlockCursor &operator =(const testBlockCursor &) = delete;
+	testBlockCursor &operator =(testBlockCursor &&) = delete;
+	~testBlockCursor() final = default;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testEmpty)
+		CRUNCHpp_TEST(testSingleRange)
+		CRUNCHpp_TEST(testMergeRanges)
+		CRUNCHpp_TEST(testSplitRanges)
+		CRUNCHpp_TEST(testResizeBlocks)
+		CRUNCHpp_TEST(testStripeAligned)
+	}
+};
+
+CRUNCHpp_TESTS(testBlockCursor)
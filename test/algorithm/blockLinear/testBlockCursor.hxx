@@ -0,0 +1,17 @@
+#ifndef TEST_BLOCK_CURSOR__HXX
+#define TEST_BLOCK_CURSOR__HXX
+
+#include <crunch++.h>
+#include <algorithm/blockLinear/blockCursor.hxx>
+
+namespace blockCursor
+{
+	extern void testEmpty(testsuite &suite);
+	extern void testSingleRange(testsuite &suite);
+	extern void testMergeRanges(testsuite &suite);
+	extern void testSplitRanges(testsuite &suite);
+	extern void testResizeBlocks(testsuite &suite);
+	extern void testStripeAligned(testsuite &suite);
+}
+
+#endif /*TEST_BLOCK_CURSOR__HXX*/
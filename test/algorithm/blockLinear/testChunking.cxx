@@ -6,12 +6,17 @@
 #include <substrate/utility>
 #include <crunch++.h>
 #include <chunking.hxx>
+#include <deviceGroups.hxx>
 #include <args.hxx>
 
 using namespace std::literals::string_view_literals;
 constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
 
-std::vector<substrate::fd_t> pcat::inputFiles{};
+pcat::inputFiles_t pcat::inputFiles{};
+pcat::deferredReads_t pcat::deferredReads{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
+pcat::deviceGroups_t pcat::deviceGroups{};
 substrate::fd_t pcat::outputFile{};
 std::atomic<bool> pcat::sync{true};
 
@@ -109,6 +114,29 @@ private:
 		checkCopyResult();
 	}
 
+	void testCopyNoWait()
+	{
+		inputFiles.clear();
+		for (const auto &file : files)
+		{
+			// Push the inputs out of the page cache so at least some of the copy goes via the slow path
+			assertTrue(file.valid());
+			fsync(file);
+			posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+			inputFiles.emplace_back(file.dup());
+		}
+		if (!resultFile.resize(inputFiles.totalLength()))
+			fail("Failed to resize the output test file");
+		outputFile = resultFile.dup();
+		args = substrate::make_unique<pcat::args::argsTree_t>();
+		assertTrue(args->add(substrate::make_unique<pcat::args::argEngine_t>("nowait"sv)));
+		assertEqual(chunkedCopy(), 0);
+		assertFalse(pcat::deferredReads.enabled());
+		assertEqual(pcat::deferredReads.pending(), 0_uz);
+		args = substrate::make_unique<pcat::args::argsTree_t>();
+		checkCopyResult();
+	}
+
 	void makeFile(const std::string_view fileName, const std::size_t size, const random_t seed) noexcept
 	{
 		const auto &file = files.emplace_back(fileName.data(), O_RDWR | O_CREAT | O_NOCTTY, normalMode);
@@ -151,6 +179,7 @@ public:
 		CRUNCHpp_TEST(testCopyNone)
 		CRUNCHpp_TEST(testCopySingle)
 		CRUNCHpp_TEST(testCopyUnaligned)
+		CRUNCHpp_TEST(testCopyNoWait)
 	}
 };
 
@@ -1,7 +1,9 @@
 #include <substrate/utility>
 #include "testChunkState.hxx"
 
-std::vector<substrate::fd_t> pcat::inputFiles{};
+pcat::inputFiles_t pcat::inputFiles{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
 
 using pcat::algorithm::chunkSpans::chunkState_t;
 using pcat::mappingOffset_t;
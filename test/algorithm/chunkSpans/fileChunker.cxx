@@ -1,13 +1,18 @@
+#include <vector>
+#include <algorithm>
 #include <substrate/utility>
 #include "testFileChunker.hxx"
 
-std::vector<substrate::fd_t> pcat::inputFiles{};
+pcat::inputFiles_t pcat::inputFiles{};
 substrate::fd_t pcat::outputFile{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
 
 using pcat::algorithm::chunkSpans::fileChunker_t;
 using pcat::algorithm::chunkSpans::chunking_t;
 using pcat::algorithm::chunkSpans::chunkState_t;
 using pcat::mappingOffset_t;
+using pcat::stripeLayout_t;
 using pcat::transferBlockSize;
 using pcat::inputFiles;
 using pcat::outputFile;
@@ -183,4 +188,19 @@ namespace fileChunker
 		++beginState;
 		suite.assertTrue(*beginState == endChunk);
 	}
+	void testFillStripedSpans(testsuite &suite)
+	{
+		suite.assertEqual(outputFile.length(), transferBlockSize * 34U);
+		suite.assertEqual(inputFiles.size(), 6);
+		// Spans of 8 stripes would all start on the same target, so they go up to 9,
+		// leaving the last span short rather than folding the remainder into it
+		pcat::stripeLayout = stripeLayout_t{transferBlockSize, 4U};
+		std::vector<off_t> spanOffsets{};
+		for (const chunkState_t &chunk : fileChunker_t{transferBlockSize * 8})
+			spanOffsets.push_back(chunk.outputOffset().offset());
+		pcat::stripeLayout = {};
+		suite.assertEqual(spanOffsets.size(), 4U);
+		for (std::size_t span{}; span < std::min<std::size_t>(spanOffsets.size(), 4U); ++span)
+			suite.assertEqual(spanOffsets[span], transferBlockSize * 9 * off_t(span));
+	}
 } // namespace fileChunker
@@ -0,0 +1,81 @@
+#include "testGuidedScheduler.hxx"
+
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
+
+using pcat::algorithm::chunkSpans::guidedScheduler_t;
+using pcat::mappingOffset_t;
+using pcat::transferBlockSize;
+using pcat::off_t;
+
+namespace guidedScheduler
+{
+	// Drains the worker's current piece, returning how much of the output it covered
+	off_t drainPiece(testsuite &suite, guidedScheduler_t &scheduler, const std::size_t worker, off_t offset)
+	{
+		const auto begin{offset};
+		for (auto block{scheduler.nextBlock(worker)}; block.length(); block = scheduler.nextBlock(worker))
+		{
+			suite.assertEqual(block.offset(), offset);
+			suite.assertTrue(block.length() <= transferBlockSize);
+			offset += block.length();
+		}
+		return offset - begin;
+	}
+
+	void testEmpty(testsuite &suite)
+	{
+		guidedScheduler_t scheduler{0, 4};
+		suite.assertEqual(scheduler.workers(), 4);
+		suite.assertFalse(scheduler.nextPiece(0));
+		suite.assertEqual(scheduler.nextBlock(0).length(), 0);
+	}
+
+	void testShrinkingPieces(testsuite &suite)
+	{
+		constexpr auto length{(transferBlockSize * 64) + 4096};
+		guidedScheduler_t scheduler{length, 4};
+		off_t offset{};
+		off_t lastLength{length};
+		while (scheduler.nextPiece(0))
+		{
+			const auto pieceLength{drainPiece(suite, scheduler, 0, offset)};
+			suite.assertTrue(pieceLength <= lastLength);
+			suite.assertTrue(pieceLength <= std::max(transferBlockSize, (length - offset) / 4));
+			offset += pieceLength;
+			lastLength = pieceLength;
+		}
+		suite.assertEqual(offset, length);
+		suite.assertEqual(lastLength, 4096);
+	}
+
+	void testSplitStraggler(testsuite &suite)
+	{
+		constexpr auto length{transferBlockSize * 16};
+		guidedScheduler_t scheduler{length, 2};
+		// Worker 0 takes the first half of the output, and worker 1 drains the rest
+		suite.assertTrue(scheduler.nextPiece(0));
+		suite.assertTrue(scheduler.nextBlock(0) == mappingOffset_t{0, transferBlockSize});
+		off_t offset{transferBlockSize * 8};
+		while (offset < length && scheduler.nextPiece(1))
+			offset += drainPiece(suite, scheduler, 1, offset);
+		suite.assertEqual(offset, length);
+
+		// Worker 1 is now idle, so should split off the back half of worker 0's remaining 7 blocks
+		suite.assertTrue(scheduler.nextPiece(1));
+		suite.assertEqual(drainPiece(suite, scheduler, 1, transferBlockSize * 4), transferBlockSize * 4);
+		suite.assertEqual(drainPiece(suite, scheduler, 0, transferBlockSize), transferBlockSize * 3);
+		// Worker 0 then splits nothing off worker 1's now empty piece and is done
+		suite.assertFalse(scheduler.nextPiece(0));
+		suite.assertFalse(scheduler.nextPiece(1));
+	}
+
+	void testAbort(testsuite &suite)
+	{
+		guidedScheduler_t scheduler{transferBlockSize * 4, 2};
+		suite.assertTrue(scheduler.nextPiece(0));
+		scheduler.abort();
+		suite.assertEqual(scheduler.nextBlock(0).length(), 0);
+		suite.assertFalse(scheduler.nextPiece(1));
+	}
+} // namespace guidedScheduler
@@ -6,12 +6,17 @@
 #include <substrate/utility>
 #include <crunch++.h>
 #include <chunking.hxx>
+#include <deviceGroups.hxx>
 #include <args.hxx>
 
 using namespace std::literals::string_view_literals;
 constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
 
-std::vector<substrate::fd_t> pcat::inputFiles{};
+pcat::inputFiles_t pcat::inputFiles{};
+pcat::deferredReads_t pcat::deferredReads{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
+pcat::deviceGroups_t pcat::deviceGroups{};
 substrate::fd_t pcat::outputFile{};
 std::atomic<bool> pcat::sync{true};
 
@@ -116,6 +121,68 @@ private:
 		checkCopyResult();
 	}
 
+	void testCopyShort()
+	{
+		inputFiles.clear();
+		inputFiles.emplace_back(files[0].dup());
+		inputFiles.emplace_back(files[1].dup());
+		inputFiles.emplace_back(files[2].dup());
+		inputFiles.emplace_back(files[4].dup());
+		inputFiles.emplace_back(files[3].dup());
+		inputFiles.emplace_back(files[5].dup());
+		if (!resultFile.resize(0) || !resultFile.resize(totalHugeSize))
+			fail("Failed to resize the output test file");
+		outputFile = resultFile.dup();
+		assertEqual(outputFile.length(), totalHugeSize);
+		// A block larger than the whole output puts the copy in the short file form, which must still copy it all
+		pcat::blockSize.fixed(pcat::maximumBlockSize);
+		assertEqual(chunkedCopy(), 0);
+		pcat::blockSize.fixed(transferBlockSize);
+		checkCopyResult();
+	}
+
+	void testCopyDeviceGroups()
+	{
+		inputFiles.clear();
+		inputFiles.emplace_back(files[0].dup());
+		inputFiles.emplace_back(files[1].dup());
+		inputFiles.emplace_back(files[2].dup());
+		inputFiles.emplace_back(files[4].dup());
+		inputFiles.emplace_back(files[3].dup());
+		inputFiles.emplace_back(files[5].dup());
+		// Put the inputs on two devices in turn so every span has to be cut where they change over
+		for (std::size_t file{}; file < inputFiles.size(); ++file)
+			pcat::deviceGroups.add(dev_t(file % 2U), inputFiles.lengthOf(file));
+		if (!resultFile.resize(0) || !resultFile.resize(totalHugeSize))
+			fail("Failed to resize the output test file");
+		outputFile = resultFile.dup();
+		assertEqual(outputFile.length(), totalHugeSize);
+		assertEqual(pcat::deviceGroups.size(), 2U);
+		assertEqual(chunkedCopy(), 0);
+		pcat::deviceGroups.clear();
+		checkCopyResult();
+	}
+
+	void testCopyGuided()
+	{
+		inputFiles.clear();
+		inputFiles.emplace_back(files[5].dup());
+		inputFiles.emplace_back(files[0].dup());
+		inputFiles.emplace_back(files[3].dup());
+		inputFiles.emplace_back(files[1].dup());
+		inputFiles.emplace_back(files[4].dup());
+		inputFiles.emplace_back(files[2].dup());
+		if (!resultFile.resize(0) || !resultFile.resize(totalHugeSize))
+			fail("Failed to resize the output test file");
+		outputFile = resultFile.dup();
+		assertEqual(outputFile.length(), totalHugeSize);
+		assertEqual(inputFiles.size(), 6);
+		assertTrue(args->add(substrate::make_unique<pcat::args::argSchedule_t>("guided"sv)));
+		assertEqual(chunkedCopy(), 0);
+		args = substrate::make_unique<pcat::args::argsTree_t>();
+		checkCopyResult();
+	}
+
 	void makeFile(const std::string_view fileName, const std::size_t size, const random_t seed) noexcept
 	{
 		const auto &file = files.emplace_back(fileName.data(), O_RDWR | O_CREAT | O_NOCTTY, normalMode);
@@ -158,6 +225,9 @@ public:
 		CRUNCHpp_TEST(testCopyNone)
 		CRUNCHpp_TEST(testCopySingle)
 		CRUNCHpp_TEST(testCopyAll)
+		CRUNCHpp_TEST(testCopyShort)
+		CRUNCHpp_TEST(testCopyDeviceGroups)
+		CRUNCHpp_TEST(testCopyGuided)
 	}
 };
 
@@ -80,6 +80,22 @@ private:
 		fileChunker::testFillLargeSpanChunk(*this);
 	}
 
+	void testFillStripedSpans()
+	{
+		inputFiles.clear();
+		inputFiles.emplace_back(files[0].dup());
+		inputFiles.emplace_back(files[1].dup());
+		inputFiles.emplace_back(files[2].dup());
+		inputFiles.emplace_back(files[4].dup());
+		inputFiles.emplace_back(files[3].dup());
+		inputFiles.emplace_back(files[5].dup());
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		if (!outputFile.resize(transferBlockSize * 34U))
+			fail("Failed to resize the output test file");
+		pcat::outputFile = outputFile.dup();
+		fileChunker::testFillStripedSpans(*this);
+	}
+
 	void makeFile(const std::string_view fileName, const std::size_t size)
 	{
 		const auto &file = files.emplace_back(fileName.data(), O_RDWR | O_CREAT | O_NOCTTY, normalMode);
@@ -121,6 +137,7 @@ public:
 		CRUNCHpp_TEST(testFillAlignedChunk)
 		CRUNCHpp_TEST(testFillUnalignedChunks)
 		CRUNCHpp_TEST(testFillLargeSpanChunk)
+		CRUNCHpp_TEST(testFillStripedSpans)
 	}
 };
 
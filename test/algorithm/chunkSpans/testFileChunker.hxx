@@ -10,6 +10,7 @@ namespace fileChunker
 	extern void testFillAlignedChunk(testsuite &suite);
 	extern void testFillUnalignedChunks(testsuite &suite);
 	extern void testFillLargeSpanChunk(testsuite &suite);
+	extern void testFillStripedSpans(testsuite &suite);
 }
 
 #endif /*TEST_FILE_CHUNKER__HXX*/
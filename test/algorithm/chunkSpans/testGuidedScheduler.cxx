@@ -0,0 +1,28 @@
+#include "testGuidedScheduler.hxx"
+
+class testGuidedScheduler final : public testsuite
+{
+private:
+	void testEmpty() { guidedScheduler::testEmpty(*this); }
+	void testShrinkingPieces() { guidedScheduler::testShrinkingPieces(*this); }
+	void testSplitStraggler() { guidedScheduler::testSplitStraggler(*this); }
+	void testAbort() { guidedScheduler::testAbort(*this); }
+
+public:
+	testGuidedScheduler() = default;
+	testGuidedScheduler(const testGuidedScheduler &) = delete;
+	testGuidedScheduler(testGuidedScheduler &&) = delete;
+	testGuidedScheduler &operator =(const testGuidedScheduler &) = delete;
+	testGuidedScheduler &operator =(testGuidedScheduler &&) = delete;
+	~testGuidedScheduler() final = default;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testEmpty)
+		CRUNCHpp_TEST(testShrinkingPieces)
+		CRUNCHpp_TEST(testSplitStraggler)
+		CRUNCHpp_TEST(testAbort)
+	}
+};
+
+CRUNCHpp_TESTS(testGuidedScheduler)
@@ -0,0 +1,15 @@
+#ifndef TEST_GUIDED_SCHEDULER__HXX
+#define TEST_GUIDED_SCHEDULER__HXX
+
+#include <crunch++.h>
+#include <algorithm/chunkSpans/guidedScheduler.hxx>
+
+namespace guidedScheduler
+{
+	extern void testEmpty(testsuite &suite);
+	extern void testShrinkingPieces(testsuite &suite);
+	extern void testSplitStraggler(testsuite &suite);
+	extern void testAbort(testsuite &suite);
+}
+
+#endif /*TEST_GUIDED_SCHEDULER__HXX*/
@@ -0,0 +1,96 @@
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include "testBufferRing.hxx"
+
+using pcat::algorithm::pipeline::bufferRing_t;
+using pcat::mappingOffset_t;
+using pcat::off_t;
+
+constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
+
+namespace bufferRing
+{
+	void testConstruct(testsuite &suite)
+	{
+		bufferRing_t ring{4, 4096};
+		suite.assertEqual(ring.count(), 4_uz);
+		suite.assertEqual(ring.bufferLength(), 4096_uz);
+		suite.assertEqual(ring.available(), 4_uz);
+		suite.assertEqual(ring.pending(), 0_uz);
+		suite.assertFalse(ring.aborted());
+		ring.abort();
+		suite.assertTrue(ring.aborted());
+	}
+
+	void testAcquireRelease(testsuite &suite)
+	{
+		bufferRing_t ring{2, 4096};
+		const auto first{ring.acquire()};
+		const auto second{ring.acquire()};
+		suite.assertEqual(ring.available(), 0_uz);
+		suite.assertNotEqual(first, second);
+		// Each buffer must be its own, non-overlapping, region of the ring
+		const auto distance{ring.data(first) > ring.data(second) ?
+			ring.data(first) - ring.data(second) : ring.data(second) - ring.data(first)};
+		suite.assertEqual(std::size_t(distance), ring.bufferLength());
+		ring.release(second);
+		ring.release(first);
+		suite.assertEqual(ring.available(), 2_uz);
+	}
+
+	void testSubmitDrain(testsuite &suite)
+	{
+		bufferRing_t ring{2, 4096};
+		const auto first{ring.acquire()};
+		const auto second{ring.acquire()};
+		ring.submit(first, {0, 4096});
+		ring.submit(second, {4096, 1024});
+		suite.assertEqual(ring.pending(), 2_uz);
+
+		const auto firstFilled{ring.drain()};
+		suite.assertTrue(firstFilled.valid());
+		suite.assertEqual(firstFilled.buffer(), first);
+		suite.assertEqual(firstFilled.block().offset(), 0);
+		suite.assertEqual(firstFilled.block().length(), 4096);
+		const auto secondFilled{ring.drain()};
+		suite.assertTrue(secondFilled.valid());
+		suite.assertEqual(secondFilled.buffer(), second);
+		suite.assertEqual(secondFilled.block().offset(), 4096);
+		suite.assertEqual(secondFilled.block().length(), 1024);
+		suite.assertEqual(ring.pending(), 0_uz);
+	}
+
+	void testClose(testsuite &suite)
+	{
+		bufferRing_t ring{1, 4096};
+		const auto buffer{ring.acquire()};
+		ring.submit(buffer, {0, 4096});
+		ring.close(2);
+		// Any filled buffers submitted before closing must still be drained first
+		suite.assertTrue(ring.drain().valid());
+		suite.assertFalse(ring.drain().valid());
+		suite.assertFalse(ring.drain().valid());
+		suite.assertEqual(ring.pending(), 0_uz);
+	}
+
+	void testBackPressure(testsuite &suite)
+	{
+		bufferRing_t ring{1, 4096};
+		std::atomic<bool> acquired{false};
+		const auto buffer{ring.acquire()};
+		std::thread reader{[&]()
+		{
+			const auto nextBuffer{ring.acquire()};
+			acquired = true;
+			ring.release(nextBuffer);
+		}};
+		// The reader must not be able to get a buffer till we give ours back
+		std::this_thread::sleep_for(std::chrono::milliseconds{10});
+		suite.assertFalse(acquired.load());
+		ring.release(buffer);
+		reader.join();
+		suite.assertTrue(acquired.load());
+		suite.assertEqual(ring.available(), 1_uz);
+	}
+} // namespace bufferRing
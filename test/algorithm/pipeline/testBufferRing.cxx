@@ -0,0 +1,30 @@
+#include "testBufferRing.hxx"
+
+class testBufferRing final : public testsuite
+{
+private:
+	void testConstruct() { bufferRing::testConstruct(*this); }
+	void testAcquireRelease() { bufferRing::testAcquireRelease(*this); }
+	void testSubmitDrain() { bufferRing::testSubmitDrain(*this); }
+	void testClose() { bufferRing::testClose(*this); }
+	void testBackPressure() { bufferRing::testBackPressure(*this); }
+
+public:
+	testBufferRing() = default;
+	testBufferRing(const testBufferRing &) = delete;
+	testBufferRing(testBufferRing &&) = delete;
+	testBufferRing &operator =(const testBufferRing &) = delete;
+	testBufferRing &operator =(testBufferRing &&) = delete;
+	~testBufferRing() final = default;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testConstruct)
+		CRUNCHpp_TEST(testAcquireRelease)
+		CRUNCHpp_TEST(testSubmitDrain)
+		CRUNCHpp_TEST(testClose)
+		CRUNCHpp_TEST(testBackPressure)
+	}
+};
+
+CRUNCHpp_TESTS(testBufferRing)
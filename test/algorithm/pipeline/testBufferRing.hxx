@@ -0,0 +1,16 @@
+#ifndef TEST_BUFFER_RING__HXX
+#define TEST_BUFFER_RING__HXX
+
+#include <crunch++.h>
+#include <algorithm/pipeline/bufferRing.hxx>
+
+namespace bufferRing
+{
+	extern void testConstruct(testsuite &suite);
+	extern void testAcquireRelease(testsuite &suite);
+	extern void testSubmitDrain(testsuite &suite);
+	extern void testClose(testsuite &suite);
+	extern void testBackPressure(testsuite &suite);
+}
+
+#endif /*TEST_BUFFER_RING__HXX*/
@@ -13,10 +13,29 @@ using pcat::args::argVersion_t;
 using pcat::args::argOutputFile_t;
 using pcat::args::argAsync_t;
 using pcat::args::argThreads_t;
+using pcat::args::argBlockSize_t;
+using pcat::args::argStripeSize_t;
+using pcat::args::argStripeCount_t;
 using pcat::args::argPinning_t;
 using pcat::args::argAlgorithm_t;
 using pcat::args::argUnrecognised_t;
+using pcat::args::argSchedule_t;
+using pcat::args::argStats_t;
+using pcat::args::argDeviceThreads_t;
+using pcat::args::argReaders_t;
+using pcat::args::argWriters_t;
+using pcat::args::argMaxOpen_t;
+using pcat::args::argFilesFrom_t;
+using pcat::args::argRecursive_t;
+using pcat::args::argSort_t;
+using pcat::args::sort_t;
+using pcat::args::argEngine_t;
+using pcat::args::engine_t;
+using pcat::args::argPlacement_t;
+using pcat::args::placement_t;
+using pcat::args::argVerbose_t;
 using pcat::args::algorithm_t;
+using pcat::args::schedule_t;
 
 constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
 
@@ -59,6 +78,19 @@ constexpr static auto invalidThreadsArgs{substrate::make_array<const char *>({"t
 constexpr static auto shortThreadsArgs{substrate::make_array<const char *>({"test", "--threads="})};
 constexpr static auto negativeThreadsArgs{substrate::make_array<const char *>({"test", "--threads", "-1"})};
 constexpr static auto nonNumericThreadsArgs{substrate::make_array<const char *>({"test", "--threads", "a1"})};
+constexpr static auto autoThreadsArgs{substrate::make_array<const char *>({"test", "--threads=auto"})};
+constexpr static auto blockSizeArgs{substrate::make_array<const char *>({"test", "--block-size=4m"})};
+constexpr static auto autoBlockSizeArgs{substrate::make_array<const char *>({"test", "--block-size", "auto"})};
+constexpr static auto zeroBlockSizeArgs{substrate::make_array<const char *>({"test", "--block-size=0"})};
+constexpr static auto unalignedBlockSizeArgs{substrate::make_array<const char *>({"test", "--block-size=1000"})};
+constexpr static auto largeBlockSizeArgs{substrate::make_array<const char *>({"test", "--block-size=128m"})};
+constexpr static auto nonNumericBlockSizeArgs{substrate::make_array<const char *>({"test", "--block-size", "x"})};
+constexpr static auto stripeArgs{
+	substrate::make_array<const char *>({"test", "--stripe-size=4m", "--stripe-count", "8"})
+};
+constexpr static auto autoStripeArgs{substrate::make_array<const char *>({"test", "--stripe-size=auto"})};
+constexpr static auto badStripeSizeArgs{substrate::make_array<const char *>({"test", "--stripe-size", "6000"})};
+constexpr static auto badStripeCountArgs{substrate::make_array<const char *>({"test", "--stripe-count=0"})};
 constexpr static auto badPinningArgs{substrate::make_array<const char *>({"test", "--core-pins"})};
 constexpr static auto invalidPinningArgs{substrate::make_array<const char *>({"test", "--core-pins", "0,"})};
 constexpr static auto shortPinningArgs{substrate::make_array<const char *>({"test", "--core-pins="})};
@@ -71,6 +103,34 @@ constexpr static auto shortAlgorithmArgs{substrate::make_array<const char *>({"t
 constexpr static auto chunkSpansAlgorithmArgs{
 	substrate::make_array<const char *>({"test", "--algorithm=chunkSpans"})
 };
+constexpr static auto autoAlgorithmArgs{substrate::make_array<const char *>({"test", "--algorithm=auto"})};
+constexpr static auto guidedScheduleArgs{substrate::make_array<const char *>({"test", "--schedule=guided"})};
+constexpr static auto badScheduleArgs{substrate::make_array<const char *>({"test", "--schedule"})};
+constexpr static auto invalidScheduleArgs{substrate::make_array<const char *>({"test", "--schedule", "dynamic"})};
+constexpr static auto deviceThreadsArgs{
+	substrate::make_array<const char *>({"test", "--device-threads=2", "--stats"})
+};
+constexpr static auto badDeviceThreadsArgs{substrate::make_array<const char *>({"test", "--device-threads"})};
+constexpr static auto invalidDeviceThreadsArgs{
+	substrate::make_array<const char *>({"test", "--device-threads", "0"})
+};
+constexpr static auto pipelineArgs{substrate::make_array<const char *>(
+	{"test", "--algorithm=pipeline", "--readers=2", "--writers", "3"}
+)};
+constexpr static auto badReadersArgs{substrate::make_array<const char *>({"test", "--readers", "0"})};
+constexpr static auto badWritersArgs{substrate::make_array<const char *>({"test", "--writers="})};
+constexpr static auto maxOpenArgs{substrate::make_array<const char *>({"test", "--max-open=64"})};
+constexpr static auto badMaxOpenArgs{substrate::make_array<const char *>({"test", "--max-open", "0"})};
+constexpr static auto filesFromArgs{
+	substrate::make_array<const char *>({"test", "--files-from=inputs.list", "input.test", "--files-from", "-"})
+};
+constexpr static auto badFilesFromArgs{substrate::make_array<const char *>({"test", "--files-from"})};
+constexpr static auto recursiveArgs{substrate::make_array<const char *>({"test", "-r", "--sort=natural"})};
+constexpr static auto badSortArgs{substrate::make_array<const char *>({"test", "--sort", "random"})};
+constexpr static auto engineArgs{substrate::make_array<const char *>({"test", "--engine=nowait"})};
+constexpr static auto badEngineArgs{substrate::make_array<const char *>({"test", "--engine", "io_uring"})};
+constexpr static auto placementArgs{substrate::make_array<const char *>({"test", "--placement=scatter", "-v"})};
+constexpr static auto badPlacementArgs{substrate::make_array<const char *>({"test", "--placement", "sockets"})};
 constexpr static auto simpleOptions{substrate::make_array<option_t>({{"--help"sv, argType_t::help}})};
 constexpr static auto assignedOptions{substrate::make_array<option_t>({{"--output"sv, argType_t::outputFile}})};
 constexpr static auto multipleOptions{substrate::make_array<option_t>(
@@ -85,8 +145,39 @@ constexpr static auto multipleOptions{substrate::make_array<option_t>(
 })};
 constexpr static auto badFileOption{substrate::make_array<option_t>({{"--output"sv, argType_t::outputFile}})};
 constexpr static auto badThreadsOption{substrate::make_array<option_t>({{"--threads"sv, argType_t::threads}})};
+constexpr static auto blockSizeOption{substrate::make_array<option_t>({{"--block-size"sv, argType_t::blockSize}})};
+constexpr static auto stripeOptions{substrate::make_array<option_t>(
+{
+	{"--stripe-size"sv, argType_t::stripeSize},
+	{"--stripe-count"sv, argType_t::stripeCount}
+})};
 constexpr static auto badPinningOption{substrate::make_array<option_t>({{"--core-pins"sv, argType_t::pinning}})};
 constexpr static auto badAlgorithmOption{substrate::make_array<option_t>({{"--algorithm"sv, argType_t::algorithm}})};
+constexpr static auto scheduleOption{substrate::make_array<option_t>({{"--schedule"sv, argType_t::schedule}})};
+constexpr static auto pipelineOptions{substrate::make_array<option_t>(
+{
+	{"--algorithm"sv, argType_t::algorithm},
+	{"--readers"sv, argType_t::readers},
+	{"--writers"sv, argType_t::writers}
+})};
+constexpr static auto deviceThreadsOptions{substrate::make_array<option_t>(
+{
+	{"--device-threads"sv, argType_t::deviceThreads},
+	{"--stats"sv, argType_t::stats}
+})};
+constexpr static auto filesFromOptions{substrate::make_array<option_t>({{"--files-from"sv, argType_t::filesFrom}})};
+constexpr static auto recursiveOptions{substrate::make_array<option_t>(
+{
+	{"-r"sv, argType_t::recursive},
+	{"--sort"sv, argType_t::sort}
+})};
+constexpr static auto engineOptions{substrate::make_array<option_t>({{"--engine"sv, argType_t::engine}})};
+constexpr static auto placementOptions{substrate::make_array<option_t>(
+{
+	{"--placement"sv, argType_t::placement},
+	{"-v"sv, argType_t::verbose}
+})};
+constexpr static auto maxOpenOptions{substrate::make_array<option_t>({{"--max-open"sv, argType_t::maxOpen}})};
 
 namespace parser
 {
@@ -169,6 +260,65 @@ namespace parser
 		}
 	};
 
+	template<> struct assertNode_t<argSchedule_t>
+	{
+		void operator()(testsuite &suite, const std::unique_ptr<argNode_t> &arg, const schedule_t schedule)
+		{
+			suite.assertNotNull(arg);
+			suite.assertEqual(static_cast<uint8_t>(arg->type()), static_cast<uint8_t>(argType_t::schedule));
+			auto *const node = dynamic_cast<argSchedule_t *>(arg.get());
+			suite.assertTrue(node->valid());
+			suite.assertEqual(static_cast<uint8_t>(node->schedule()), static_cast<uint8_t>(schedule));
+		}
+	};
+
+	template<> struct assertNode_t<argSort_t>
+	{
+		void operator()(testsuite &suite, const std::unique_ptr<argNode_t> &arg, const sort_t sort)
+		{
+			suite.assertNotNull(arg);
+			suite.assertEqual(static_cast<uint8_t>(arg->type()), static_cast<uint8_t>(argType_t::sort));
+			auto *const node = dynamic_cast<argSort_t *>(arg.get());
+			suite.assertTrue(node->valid());
+			suite.assertEqual(static_cast<uint8_t>(node->sort()), static_cast<uint8_t>(sort));
+		}
+	};
+
+	template<> struct assertNode_t<argEngine_t>
+	{
+		void operator()(testsuite &suite, const std::unique_ptr<argNode_t> &arg, const engine_t engine)
+		{
+			suite.assertNotNull(arg);
+			suite.assertEqual(static_cast<uint8_t>(arg->type()), static_cast<uint8_t>(argType_t::engine));
+			auto *const node = dynamic_cast<argEngine_t *>(arg.get());
+			suite.assertTrue(node->valid());
+			suite.assertEqual(static_cast<uint8_t>(node->engine()), static_cast<uint8_t>(engine));
+		}
+	};
+
+	template<> struct assertNode_t<argPlacement_t>
+	{
+		void operator()(testsuite &suite, const std::unique_ptr<argNode_t> &arg, const placement_t placement)
+		{
+			suite.assertNotNull(arg);
+			suite.assertEqual(static_cast<uint8_t>(arg->type()), static_cast<uint8_t>(argType_t::placement));
+			auto *const node = dynamic_cast<argPlacement_t *>(arg.get());
+			suite.assertTrue(node->valid());
+			suite.assertEqual(static_cast<uint8_t>(node->placement()), static_cast<uint8_t>(placement));
+		}
+	};
+
+	template<argType_t type> struct assertNode_t<pcat::args::argCount_t<type>>
+	{
+		void operator()(testsuite &suite, const std::unique_ptr<argNode_t> &arg, const std::size_t count)
+		{
+			suite.assertNotNull(arg);
+			suite.assertEqual(static_cast<uint8_t>(arg->type()), static_cast<uint8_t>(type));
+			auto *const node = dynamic_cast<pcat::args::argCount_t<type> *>(arg.get());
+			suite.assertEqual(node->count(), count);
+		}
+	};
+
 	void testSimple(testsuite &suite)
 	{
 		args = {};
@@ -475,6 +625,20 @@ namespace parser
 		suite.assertNull(args->find(argType_t::unrecognised));
 	}
 
+	void testAutoAlgorithm(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(autoAlgorithmArgs.size(), autoAlgorithmArgs.data(), badAlgorithmOption));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 1);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argAlgorithm_t>{}(suite, *iterator, algorithm_t::automatic);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+		suite.assertNull(args->find(argType_t::unrecognised));
+	}
+
 	void testBadAlgorithm(testsuite &suite)
 	{
 		args = {};
@@ -494,4 +658,301 @@ namespace parser
 		suite.assertNotNull(args);
 		suite.assertEqual(args->count(), 0);
 	}
+
+	void testGuidedSchedule(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(guidedScheduleArgs.size(), guidedScheduleArgs.data(), scheduleOption));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 1);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argSchedule_t>{}(suite, *iterator, schedule_t::guidedSpans);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+		suite.assertNull(args->find(argType_t::unrecognised));
+	}
+
+	void testBadSchedule(testsuite &suite)
+	{
+		args = {};
+		suite.assertFalse(parseArguments(badScheduleArgs.size(), badScheduleArgs.data(), scheduleOption));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+
+		args = {};
+		suite.assertFalse(parseArguments(invalidScheduleArgs.size(), invalidScheduleArgs.data(), scheduleOption));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testDeviceThreads(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(deviceThreadsArgs.size(), deviceThreadsArgs.data(), deviceThreadsOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 2);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argDeviceThreads_t>{}(suite, *iterator, 2_uz);
+		++iterator;
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argStats_t>{}(suite, *iterator);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+		suite.assertNull(args->find(argType_t::unrecognised));
+	}
+
+	void testBadDeviceThreads(testsuite &suite)
+	{
+		args = {};
+		suite.assertFalse(
+			parseArguments(badDeviceThreadsArgs.size(), badDeviceThreadsArgs.data(), deviceThreadsOptions)
+		);
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+
+		args = {};
+		suite.assertFalse(
+			parseArguments(invalidDeviceThreadsArgs.size(), invalidDeviceThreadsArgs.data(), deviceThreadsOptions)
+		);
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testPipelineAlgorithm(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(pipelineArgs.size(), pipelineArgs.data(), pipelineOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 3);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argAlgorithm_t>{}(suite, *iterator, algorithm_t::pipeline);
+		++iterator;
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argReaders_t>{}(suite, *iterator, 2_uz);
+		++iterator;
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argWriters_t>{}(suite, *iterator, 3_uz);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+		suite.assertNull(args->find(argType_t::unrecognised));
+	}
+
+	void testBadStageThreads(testsuite &suite)
+	{
+		args = {};
+		suite.assertFalse(parseArguments(badReadersArgs.size(), badReadersArgs.data(), pipelineOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+
+		args = {};
+		suite.assertFalse(parseArguments(badWritersArgs.size(), badWritersArgs.data(), pipelineOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testMaxOpen(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(maxOpenArgs.size(), maxOpenArgs.data(), maxOpenOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 1);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argMaxOpen_t>{}(suite, *iterator, 64_uz);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+
+		args = {};
+		suite.assertFalse(parseArguments(badMaxOpenArgs.size(), badMaxOpenArgs.data(), maxOpenOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testFilesFrom(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(filesFromArgs.size(), filesFromArgs.data(), filesFromOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 3);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		suite.assertEqual(static_cast<uint8_t>((*iterator)->type()), static_cast<uint8_t>(argType_t::filesFrom));
+		suite.assertTrue(dynamic_cast<argFilesFrom_t &>(**iterator).fileName() == "inputs.list"sv);
+		suite.assertEqual(args->find(argType_t::filesFrom), iterator->get());
+		++iterator;
+		suite.assertTrue(iterator != args->end());
+		suite.assertEqual(static_cast<uint8_t>((*iterator)->type()), static_cast<uint8_t>(argType_t::unrecognised));
+		++iterator;
+		suite.assertTrue(iterator != args->end());
+		suite.assertEqual(static_cast<uint8_t>((*iterator)->type()), static_cast<uint8_t>(argType_t::filesFrom));
+		suite.assertTrue(dynamic_cast<argFilesFrom_t &>(**iterator).fileName() == "-"sv);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+
+		args = {};
+		suite.assertFalse(parseArguments(badFilesFromArgs.size(), badFilesFromArgs.data(), filesFromOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testRecursive(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(recursiveArgs.size(), recursiveArgs.data(), recursiveOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 2);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argRecursive_t>{}(suite, *iterator);
+		++iterator;
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argSort_t>{}(suite, *iterator, sort_t::natural);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+
+		args = {};
+		suite.assertFalse(parseArguments(badSortArgs.size(), badSortArgs.data(), recursiveOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testEngine(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(engineArgs.size(), engineArgs.data(), engineOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 1);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argEngine_t>{}(suite, *iterator, engine_t::nowait);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+
+		args = {};
+		suite.assertFalse(parseArguments(badEngineArgs.size(), badEngineArgs.data(), engineOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testPlacement(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(placementArgs.size(), placementArgs.data(), placementOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 2);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argPlacement_t>{}(suite, *iterator, placement_t::scatter);
+		++iterator;
+		suite.assertTrue(iterator != args->end());
+		assertNode_t<argVerbose_t>{}(suite, *iterator);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+
+		args = {};
+		suite.assertFalse(parseArguments(badPlacementArgs.size(), badPlacementArgs.data(), placementOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testAutoThreads(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(autoThreadsArgs.size(), autoThreadsArgs.data(), badThreadsOption));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 1);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		suite.assertEqual(static_cast<uint8_t>((*iterator)->type()), static_cast<uint8_t>(argType_t::threads));
+		auto *const node = dynamic_cast<argThreads_t *>(iterator->get());
+		suite.assertNotNull(node);
+		suite.assertTrue(node->automatic());
+		suite.assertEqual(node->threads(), 0);
+		++iterator;
+		suite.assertTrue(iterator == args->end());
+	}
+
+	void assertBlockSize(testsuite &suite, const bool automatic, const std::size_t size)
+	{
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 1);
+		auto iterator = args->begin();
+		suite.assertTrue(iterator != args->end());
+		suite.assertEqual(static_cast<uint8_t>((*iterator)->type()), static_cast<uint8_t>(argType_t::blockSize));
+		auto *const node = dynamic_cast<argBlockSize_t *>(iterator->get());
+		suite.assertNotNull(node);
+		suite.assertEqual(node->automatic(), automatic);
+		suite.assertEqual(node->size(), size);
+	}
+
+	void testBlockSize(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(blockSizeArgs.size(), blockSizeArgs.data(), blockSizeOption));
+		assertBlockSize(suite, false, 4U * 1024U * 1024U);
+
+		args = {};
+		suite.assertTrue(parseArguments(autoBlockSizeArgs.size(), autoBlockSizeArgs.data(), blockSizeOption));
+		assertBlockSize(suite, true, 0U);
+
+		args = {};
+		suite.assertFalse(parseArguments(zeroBlockSizeArgs.size(), zeroBlockSizeArgs.data(), blockSizeOption));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+
+		args = {};
+		suite.assertFalse(
+			parseArguments(unalignedBlockSizeArgs.size(), unalignedBlockSizeArgs.data(), blockSizeOption)
+		);
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+
+		args = {};
+		suite.assertFalse(parseArguments(largeBlockSizeArgs.size(), largeBlockSizeArgs.data(), blockSizeOption));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+
+		args = {};
+		suite.assertFalse(
+			parseArguments(nonNumericBlockSizeArgs.size(), nonNumericBlockSizeArgs.data(), blockSizeOption)
+		);
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
+
+	void testStripes(testsuite &suite)
+	{
+		args = {};
+		suite.assertTrue(parseArguments(stripeArgs.size(), stripeArgs.data(), stripeOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 2);
+		const auto *const size = dynamic_cast<argStripeSize_t *>(args->find(argType_t::stripeSize));
+		suite.assertNotNull(size);
+		suite.assertFalse(size->automatic());
+		suite.assertEqual(size->size(), std::size_t{4U * 1024U * 1024U});
+		const auto *const count = dynamic_cast<argStripeCount_t *>(args->find(argType_t::stripeCount));
+		suite.assertNotNull(count);
+		suite.assertEqual(count->count(), std::size_t{8U});
+
+		args = {};
+		suite.assertTrue(parseArguments(autoStripeArgs.size(), autoStripeArgs.data(), stripeOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 1);
+		const auto *const automatic = dynamic_cast<argStripeSize_t *>(args->find(argType_t::stripeSize));
+		suite.assertNotNull(automatic);
+		suite.assertTrue(automatic->automatic());
+
+		args = {};
+		suite.assertFalse(parseArguments(badStripeSizeArgs.size(), badStripeSizeArgs.data(), stripeOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+
+		args = {};
+		suite.assertFalse(parseArguments(badStripeCountArgs.size(), badStripeCountArgs.data(), stripeOptions));
+		suite.assertNotNull(args);
+		suite.assertEqual(args->count(), 0);
+	}
 } // namespace parser
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <substrate/units>
+#include <blockSize.hxx>
+#include "testBlockSize.hxx"
+
+using namespace std::literals::chrono_literals;
+using substrate::operator ""_KiB;
+using substrate::operator ""_MiB;
+using substrate::operator ""_GiB;
+using pcat::off_t;
+using pcat::blockSize_t;
+using pcat::transferBlockSize;
+using pcat::minimumBlockSize;
+using pcat::maximumBlockSize;
+
+namespace blockSize
+{
+	// Feeds the block size enough full blocks taking the given time each for it to make a decision
+	void timeBlocks(blockSize_t &size, const std::chrono::nanoseconds elapsed)
+	{
+		const auto length{size.current()};
+		for (std::size_t block{}; block < blockSize_t::sampleBlocks; ++block)
+			size.completed(length, elapsed);
+	}
+
+	void testFixed(testsuite &suite)
+	{
+		blockSize_t size{};
+		suite.assertEqual(size.current(), transferBlockSize);
+		suite.assertFalse(size.adaptive());
+		size.fixed(off_t(4_MiB));
+		suite.assertEqual(size.current(), off_t(4_MiB));
+		suite.assertFalse(size.adaptive());
+		// A fixed size never changes however long blocks take
+		timeBlocks(size, 1us);
+		suite.assertEqual(size.current(), off_t(4_MiB));
+		size.fixed(off_t(1_GiB));
+		suite.assertEqual(size.current(), maximumBlockSize);
+	}
+
+	void testAdaptStart(testsuite &suite)
+	{
+		blockSize_t size{};
+		// A small preferred IO size, as for local filesystems, starts out from the default
+		size.adapt(off_t(4_KiB), off_t(16_GiB), 4U);
+		suite.assertTrue(size.adaptive());
+		suite.assertEqual(size.current(), transferBlockSize);
+		suite.assertEqual(size.minimum(), minimumBlockSize);
+		suite.assertEqual(size.maximum(), maximumBlockSize);
+
+		// A stripe size larger than the default is started from, and becomes the smallest size used
+		size.adapt(off_t(4_MiB), off_t(1_GiB), 4U);
+		suite.assertEqual(size.current(), off_t(4_MiB));
+		suite.assertEqual(size.minimum(), off_t(4_MiB));
+
+		// A short output caps the size so every worker still gets tailBlocks blocks
+		size.adapt(off_t(4_KiB), off_t(16_MiB), 4U);
+		suite.assertEqual(size.maximum(), off_t(512_KiB));
+		suite.assertEqual(size.current(), off_t(512_KiB));
+	}
+
+	void testAdaptGrow(testsuite &suite)
+	{
+		blockSize_t size{};
+		size.adapt(off_t(4_KiB), off_t(1_GiB), 4U);
+		// Short blocks, as at the end of an input, don't count towards a decision
+		for (std::size_t block{}; block < blockSize_t::sampleBlocks * 2U; ++block)
+			size.completed(size.current() / 2, 1us);
+		suite.assertEqual(size.current(), transferBlockSize);
+		// Quick blocks double the size, up to the maximum
+		timeBlocks(size, 100us);
+		suite.assertEqual(size.current(), transferBlockSize * 2);
+		for (std::size_t round{}; round < 16U; ++round)
+			timeBlocks(size, 100us);
+		suite.assertEqual(size.current(), off_t(32_MiB));
+		// Blocks inside the target range leave the size where it is
+		timeBlocks(size, 10ms);
+		suite.assertEqual(size.current(), off_t(32_MiB));
+	}
+
+	void testAdaptShrink(testsuite &suite)
+	{
+		blockSize_t size{};
+		size.adapt(off_t(4_KiB), off_t(1_GiB), 4U);
+		// Slow blocks halve the size, down to the minimum
+		timeBlocks(size, 100ms);
+		suite.assertEqual(size.current(), transferBlockSize / 2);
+		for (std::size_t round{}; round < 16U; ++round)
+			timeBlocks(size, 100ms);
+		suite.assertEqual(size.current(), minimumBlockSize);
+
+		// With a stripe size set, the size stays a whole number of stripes
+		size.adapt(off_t(3_MiB), off_t(16_GiB), 1U);
+		suite.assertEqual(size.current(), off_t(3_MiB));
+		timeBlocks(size, 1us);
+		suite.assertEqual(size.current(), off_t(6_MiB));
+		timeBlocks(size, 1s);
+		suite.assertEqual(size.current(), off_t(3_MiB));
+	}
+} // namespace blockSize
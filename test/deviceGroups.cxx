@@ -0,0 +1,131 @@
+#include <string_view>
+#include <vector>
+#ifndef _WINDOWS
+#	include <sys/sysmacros.h>
+#endif
+#include <deviceGroups.hxx>
+#include "testDeviceGroups.hxx"
+#ifndef _WINDOWS
+#	include "fakeTree.hxx"
+#endif
+
+constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
+
+using namespace std::literals::string_view_literals;
+using pcat::deviceGroups_t;
+using pcat::deviceNode;
+using pcat::noNode;
+
+namespace deviceGroups
+{
+	void testGrouping(testsuite &suite)
+	{
+		deviceGroups_t groups{};
+		suite.assertTrue(groups.empty());
+		suite.assertEqual(groups.groupOf(0), 0_uz);
+
+		groups.add(dev_t{8}, 1024);
+		groups.add(dev_t{16}, 512);
+		groups.add(dev_t{8}, 2048);
+		suite.assertFalse(groups.empty());
+		suite.assertEqual(groups.size(), 2_uz);
+		suite.assertEqual(groups.groupOf(0), 0_uz);
+		suite.assertEqual(groups.groupOf(1), 1_uz);
+		suite.assertEqual(groups.groupOf(2), 0_uz);
+		// Files we know nothing about land in the first group
+		suite.assertEqual(groups.groupOf(3), 0_uz);
+
+		suite.assertTrue(groups[0].device() == dev_t{8});
+		suite.assertEqual(groups[0].files(), 2_uz);
+		suite.assertEqual(groups[0].bytes(), 3072);
+		suite.assertTrue(groups[1].device() == dev_t{16});
+		suite.assertEqual(groups[1].files(), 1_uz);
+		suite.assertEqual(groups[1].bytes(), 512);
+
+		groups.clear();
+		suite.assertTrue(groups.empty());
+		suite.assertEqual(groups.size(), 0_uz);
+	}
+
+	void testAssignWorkers(testsuite &suite)
+	{
+		deviceGroups_t groups{};
+		groups.add(dev_t{1}, 1);
+		groups.add(dev_t{2}, 1);
+		groups.add(dev_t{3}, 1);
+
+		groups.assignWorkers(8);
+		suite.assertEqual(groups[0].workers(), 3_uz);
+		suite.assertEqual(groups[1].workers(), 3_uz);
+		suite.assertEqual(groups[2].workers(), 2_uz);
+
+		// Every group must get at least one worker even when there are fewer processors than groups
+		groups.assignWorkers(2);
+		suite.assertEqual(groups[0].workers(), 1_uz);
+		suite.assertEqual(groups[1].workers(), 1_uz);
+		suite.assertEqual(groups[2].workers(), 1_uz);
+	}
+
+	void testWorkerLimit(testsuite &suite)
+	{
+		deviceGroups_t groups{};
+		groups.add(dev_t{1}, 1);
+		groups.add(dev_t{2}, 1);
+
+		groups.assignWorkers(8, 2);
+		suite.assertEqual(groups[0].workers(), 2_uz);
+		suite.assertEqual(groups[1].workers(), 2_uz);
+	}
+
+#ifndef _WINDOWS
+	// An NVMe disk on node 1 and a partition of it, which like in sysfs proper is linked in under the disk
+	std::vector<fakeTree::entry_t> fakeSysfs()
+	{
+		return
+		{
+			fakeTree::directory("sys.test"), fakeTree::directory("sys.test/dev"),
+			fakeTree::directory("sys.test/dev/block"), fakeTree::directory("sys.test/block"),
+			fakeTree::directory("sys.test/block/nvme0n1"), fakeTree::directory("sys.test/block/nvme0n1/device"),
+			fakeTree::directory("sys.test/block/nvme0n1/nvme0n1p1"),
+			fakeTree::file("sys.test/block/nvme0n1/device/numa_node", "1\n"sv),
+			// A disk on a controller that isn't attached to any one node
+			fakeTree::directory("sys.test/block/sda"), fakeTree::directory("sys.test/block/sda/device"),
+			fakeTree::file("sys.test/block/sda/device/numa_node", "-1\n"sv),
+			fakeTree::link("sys.test/dev/block/259:0", "../../block/nvme0n1"sv),
+			fakeTree::link("sys.test/dev/block/259:1", "../../block/nvme0n1/nvme0n1p1"sv),
+			fakeTree::link("sys.test/dev/block/8:0", "../../block/sda"sv)
+		};
+	}
+
+	void testDeviceNodes(testsuite &suite)
+	{
+		const fakeTree::fakeTree_t tree{fakeSysfs()};
+		suite.assertTrue(tree.valid());
+		const auto diskNode{deviceNode(makedev(259, 0), "sys.test"sv)};
+		const auto partitionNode{deviceNode(makedev(259, 1), "sys.test"sv)};
+		const auto anyNode{deviceNode(makedev(8, 0), "sys.test"sv)};
+		const auto unknownNode{deviceNode(makedev(0, 27), "sys.test"sv)};
+
+		deviceGroups_t groups{};
+		groups.add(makedev(8, 0), 1);
+		groups.add(makedev(259, 1), 1);
+		// Without a node of its own, a group's workers go near the output
+		groups.locate(makedev(259, 0), "sys.test"sv);
+		const auto firstNode{groups[0].node()};
+		const auto secondNode{groups[1].node()};
+		groups.locate(makedev(0, 27), "sys.test"sv);
+		const auto unplacedNode{groups[0].node()};
+
+		suite.assertEqual(diskNode, 1);
+		suite.assertEqual(partitionNode, 1);
+		suite.assertEqual(anyNode, noNode);
+		suite.assertEqual(unknownNode, noNode);
+		suite.assertEqual(firstNode, 1);
+		suite.assertEqual(secondNode, 1);
+		suite.assertEqual(unplacedNode, noNode);
+	}
+#else
+	void testDeviceNodes(testsuite &suite)
+		{ suite.skip("Device NUMA nodes are only read from sysfs on Linux"); }
+#endif
+} // namespace deviceGroups
@@ -0,0 +1,161 @@
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <substrate/fd>
+#include <substrate/utility>
+#include <directoryWalk.hxx>
+#include "testDirectoryWalk.hxx"
+
+using namespace std::literals::string_view_literals;
+using substrate::fd_t;
+using substrate::normalMode;
+using pcat::directoryWalk_t;
+using pcat::naturalLess;
+using pcat::args::sort_t;
+
+constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
+
+constexpr static auto treeDirectories{substrate::make_array<std::string_view>(
+	{"walk.test"sv, "walk.test/rank_2"sv, "walk.test/rank_10"sv, "walk.test/rank_10/sub"sv}
+)};
+constexpr static auto treeFiles{substrate::make_array<std::string_view>(
+{
+	"walk.test/rank_1"sv,
+	"walk.test/rank_2/b"sv,
+	"walk.test/rank_2/a"sv,
+	"walk.test/rank_10/sub/c"sv,
+	"walk.test/rank_10/d"sv,
+	"walk.test/rank_9"sv
+})};
+
+constexpr static auto lexicalOrder{substrate::make_array<std::string_view>(
+{
+	"walk.test/rank_1"sv,
+	"walk.test/rank_10/d"sv,
+	"walk.test/rank_10/sub/c"sv,
+	"walk.test/rank_2/a"sv,
+	"walk.test/rank_2/b"sv,
+	"walk.test/rank_9"sv
+})};
+
+constexpr static auto naturalOrder{substrate::make_array<std::string_view>(
+{
+	"walk.test/rank_1"sv,
+	"walk.test/rank_2/a"sv,
+	"walk.test/rank_2/b"sv,
+	"walk.test/rank_9"sv,
+	"walk.test/rank_10/d"sv,
+	"walk.test/rank_10/sub/c"sv
+})};
+
+namespace directoryWalk
+{
+	void makeTree(testsuite &suite)
+	{
+		for (const auto &directory : treeDirectories)
+			suite.assertEqual(mkdir(directory.data(), 0755), 0);
+		for (const auto &fileName : treeFiles)
+		{
+			fd_t file{fileName.data(), O_RDWR | O_CREAT | O_NOCTTY, normalMode};
+			suite.assertTrue(file.valid());
+		}
+	}
+
+	void removeTree()
+	{
+		for (const auto &fileName : treeFiles)
+			unlink(fileName.data());
+		for (auto directory{treeDirectories.rbegin()}; directory != treeDirectories.rend(); ++directory)
+			rmdir(directory->data());
+	}
+
+	// Walks the tree with a few workers to make sure the order doesn't depend on which lists what
+	template<std::size_t count> void checkWalk(testsuite &suite, const sort_t order,
+		const std::array<std::string_view, count> &expected)
+	{
+		directoryWalk_t walk{"walk.test"sv, order};
+		std::vector<std::thread> workers{};
+		for (std::size_t worker{}; worker < 4U; ++worker)
+			workers.emplace_back([&walk]() { [[maybe_unused]] const auto result{walk.run()}; });
+		for (auto &worker : workers)
+			worker.join();
+		suite.assertTrue(walk.valid());
+		suite.assertEqual(walk.directoryCount(), treeDirectories.size());
+		const auto files{walk.files()};
+		suite.assertEqual(files.size(), expected.size());
+		for (std::size_t index{}; index < files.size(); ++index)
+			suite.assertTrue(files[index] == expected[index]);
+	}
+
+	void testNaturalLess(testsuite &suite)
+	{
+		suite.assertTrue(naturalLess("rank_9"sv, "rank_10"sv));
+		suite.assertFalse(naturalLess("rank_10"sv, "rank_9"sv));
+		suite.assertTrue(naturalLess("rank_0009"sv, "rank_0010"sv));
+		suite.assertTrue(naturalLess("a2b"sv, "a2c"sv));
+		suite.assertTrue(naturalLess("a"sv, "a1"sv));
+		suite.assertTrue(naturalLess("file"sv, "file.1"sv));
+		suite.assertFalse(naturalLess("same"sv, "same"sv));
+		// Equal values still need a consistent order
+		suite.assertTrue(naturalLess("rank_009"sv, "rank_9"sv) != naturalLess("rank_9"sv, "rank_009"sv));
+	}
+
+	void testLexicalWalk(testsuite &suite)
+	{
+		makeTree(suite);
+		checkWalk(suite, sort_t::lexical, lexicalOrder);
+		removeTree();
+	}
+
+	void testNaturalWalk(testsuite &suite)
+	{
+		makeTree(suite);
+		checkWalk(suite, sort_t::natural, naturalOrder);
+		removeTree();
+	}
+
+	void testMissing(testsuite &suite)
+	{
+		directoryWalk_t walk{"missing.test"sv, sort_t::lexical};
+		suite.assertEqual(walk.run(), ENOENT);
+		suite.assertFalse(walk.valid());
+		suite.assertEqual(walk.error(), ENOENT);
+		suite.assertEqual(walk.files().size(), 0_uz);
+	}
+
+	void testEntryKind(testsuite &suite)
+	{
+#ifndef _WINDOWS
+		suite.assertEqual(mkdir("kind.test", 0755), 0);
+		suite.assertEqual(mkdir("kind.test/dir", 0755), 0);
+		{
+			const fd_t file{"kind.test/file", O_RDWR | O_CREAT | O_NOCTTY, normalMode};
+			suite.assertTrue(file.valid());
+		}
+		suite.assertEqual(symlink("dir", "kind.test/toDir"), 0);
+		suite.assertEqual(symlink("file", "kind.test/toFile"), 0);
+		const fd_t dir{"kind.test", O_RDONLY | O_DIRECTORY | O_NOCTTY};
+		suite.assertTrue(dir.valid());
+
+		// With no type from the listing, the entries must be asked after without following links to directories
+		suite.assertEqual(directoryWalk_t::kindOf(dir, "file", DT_UNKNOWN), 1U);
+		suite.assertEqual(directoryWalk_t::kindOf(dir, "dir", DT_UNKNOWN), 2U);
+		suite.assertEqual(directoryWalk_t::kindOf(dir, "toFile", DT_UNKNOWN), 1U);
+		suite.assertEqual(directoryWalk_t::kindOf(dir, "toDir", DT_UNKNOWN), 0U);
+		suite.assertEqual(directoryWalk_t::kindOf(dir, "missing", DT_UNKNOWN), 0U);
+		// And the same for entries the listing says are links
+		suite.assertEqual(directoryWalk_t::kindOf(dir, "toFile", DT_LNK), 1U);
+		suite.assertEqual(directoryWalk_t::kindOf(dir, "toDir", DT_LNK), 0U);
+
+		unlink("kind.test/toFile");
+		unlink("kind.test/toDir");
+		unlink("kind.test/file");
+		rmdir("kind.test/dir");
+		rmdir("kind.test");
+#else
+		suite.skip("Entry types are only worked out from directory listings off Windows");
+#endif
+	}
+} // namespace directoryWalk
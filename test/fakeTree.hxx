@@ -0,0 +1,97 @@
+#ifndef FAKE_TREE__HXX
+#define FAKE_TREE__HXX
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <substrate/fd>
+
+namespace fakeTree
+{
+	using substrate::fd_t;
+	using substrate::normalMode;
+
+	enum class kind_t
+	{
+		directory,
+		file,
+		link
+	};
+
+	// One entry in a fake tree, where contents is what's written to a file or what a link points to
+	struct entry_t final
+	{
+		kind_t kind;
+		std::string path;
+		std::string contents{};
+	};
+
+	[[nodiscard]] inline entry_t directory(std::string path) { return {kind_t::directory, std::move(path)}; }
+	[[nodiscard]] inline entry_t file(std::string path, const std::string_view contents = {})
+		{ return {kind_t::file, std::move(path), std::string{contents}}; }
+	[[nodiscard]] inline entry_t link(std::string path, const std::string_view target)
+		{ return {kind_t::link, std::move(path), std::string{target}}; }
+
+	/*!
+	 * Builds a tree of directories, files and links, in the order given, for the tests to
+	 * point the sysfs and cgroup readers at in place of the real thing. The tree is taken
+	 * down again in reverse order when this goes out of scope, so a failed assertion can't
+	 * leave it behind for the next run to trip over.
+	 */
+	struct fakeTree_t final
+	{
+	private:
+		std::vector<entry_t> entries_;
+		std::size_t made{0};
+
+		[[nodiscard]] static bool make(const entry_t &entry) noexcept
+		{
+			switch (entry.kind)
+			{
+				case kind_t::directory:
+					return mkdir(entry.path.c_str(), 0755) == 0;
+				case kind_t::link:
+					return symlink(entry.contents.c_str(), entry.path.c_str()) == 0;
+				default:
+				{
+					const fd_t file{entry.path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOCTTY, normalMode};
+					return file.valid() && file.write(entry.contents.data(), entry.contents.size());
+				}
+			}
+		}
+
+	public:
+		fakeTree_t(std::vector<entry_t> entries) : entries_{std::move(entries)}
+		{
+			while (made < entries_.size() && make(entries_[made]))
+				++made;
+		}
+
+		fakeTree_t(const fakeTree_t &) = delete;
+		fakeTree_t(fakeTree_t &&) = delete;
+
+		~fakeTree_t() noexcept
+		{
+			while (made)
+			{
+				const auto &entry{entries_[--made]};
+				if (entry.kind == kind_t::directory)
+					rmdir(entry.path.c_str());
+				else
+					unlink(entry.path.c_str());
+			}
+		}
+
+		fakeTree_t &operator =(const fakeTree_t &) = delete;
+		fakeTree_t &operator =(fakeTree_t &&) = delete;
+
+		// Checks that every entry of the tree was made
+		[[nodiscard]] bool valid() const noexcept { return made == entries_.size(); }
+	};
+} // namespace fakeTree
+
+#endif /*FAKE_TREE__HXX*/
@@ -0,0 +1,94 @@
+#include <cerrno>
+#include <string_view>
+#include <substrate/fd>
+#include <substrate/utility>
+#include <fileList.hxx>
+#include "testFileList.hxx"
+
+using namespace std::literals::string_view_literals;
+using substrate::fd_t;
+using substrate::normalMode;
+using pcat::fileList_t;
+
+constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
+
+constexpr static auto listFile{"inputs.list"sv};
+constexpr static auto expectedEntries{substrate::make_array<std::string_view>(
+	{"input1.test"sv, "input 2.test"sv, "dir/input3.test"sv}
+)};
+
+namespace fileList
+{
+	void writeList(testsuite &suite, const std::string_view contents)
+	{
+		fd_t file{listFile.data(), O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, normalMode};
+		suite.assertTrue(file.valid());
+		suite.assertTrue(file.write(contents.data(), contents.size()));
+	}
+
+	void checkEntries(testsuite &suite, const fileList_t &list)
+	{
+		suite.assertTrue(list.valid());
+		const auto &entries{list.entries()};
+		suite.assertEqual(entries.size(), expectedEntries.size());
+		for (std::size_t index{}; index < entries.size(); ++index)
+			suite.assertTrue(entries[index] == expectedEntries[index]);
+	}
+
+	void testNewlines(testsuite &suite)
+	{
+		writeList(suite, "input1.test\ninput 2.test\n\ndir/input3.test\n"sv);
+		{
+			const fileList_t list{listFile};
+			checkEntries(suite, list);
+		}
+		unlink(listFile.data());
+	}
+
+	void testNULs(testsuite &suite)
+	{
+		// Once NUL separated, newlines are part of the entries rather than separators
+		writeList(suite, "input1.test\0input 2.test\0dir/input3.test\0"sv);
+		{
+			const fileList_t list{listFile};
+			checkEntries(suite, list);
+		}
+		writeList(suite, "line\nbreak\0"sv);
+		{
+			const fileList_t list{listFile};
+			suite.assertTrue(list.valid());
+			suite.assertEqual(list.entries().size(), 1_uz);
+			suite.assertTrue(list.entries()[0] == "line\nbreak"sv);
+		}
+		unlink(listFile.data());
+	}
+
+	void testUnterminated(testsuite &suite)
+	{
+		writeList(suite, "input1.test\ninput 2.test\ndir/input3.test"sv);
+		{
+			const fileList_t list{listFile};
+			checkEntries(suite, list);
+		}
+		unlink(listFile.data());
+	}
+
+	void testEmpty(testsuite &suite)
+	{
+		writeList(suite, ""sv);
+		{
+			const fileList_t list{listFile};
+			suite.assertTrue(list.valid());
+			suite.assertTrue(list.entries().empty());
+		}
+		unlink(listFile.data());
+	}
+
+	void testMissing(testsuite &suite)
+	{
+		const fileList_t list{"missing.list"sv};
+		suite.assertFalse(list.valid());
+		suite.assertEqual(list.error(), ENOENT);
+		suite.assertTrue(list.entries().empty());
+	}
+} // namespace fileList
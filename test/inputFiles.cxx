@@ -0,0 +1,172 @@
+#include <string_view>
+#include <tuple>
+#include <substrate/fd>
+#include <substrate/utility>
+#include <inputFiles.hxx>
+#include "testInputFiles.hxx"
+
+using namespace std::literals::string_view_literals;
+using substrate::fd_t;
+using substrate::normalMode;
+using pcat::inputFiles_t;
+using pcat::off_t;
+
+constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
+
+constexpr static auto testFiles{substrate::make_array<std::pair<std::string_view, off_t>>(
+{
+	{"input1.test"sv, 1024},
+	{"input2.test"sv, 4096},
+	{"input3.test"sv, 512}
+})};
+
+namespace inputFiles
+{
+	void makeInputs(testsuite &suite, inputFiles_t &inputs)
+	{
+		for (const auto &[fileName, length] : testFiles)
+		{
+			fd_t file{fileName.data(), O_RDWR | O_CREAT | O_NOCTTY, normalMode};
+			suite.assertTrue(file.valid());
+			suite.assertTrue(file.resize(length));
+			inputs.emplace_back(std::move(file));
+			unlink(fileName.data());
+		}
+	}
+
+	void testEmpty(testsuite &suite)
+	{
+		inputFiles_t inputs{};
+		suite.assertTrue(inputs.empty());
+		suite.assertEqual(inputs.size(), 0_uz);
+		suite.assertTrue(inputs.begin() == inputs.end());
+		suite.assertEqual(inputs.totalLength(), 0);
+		suite.assertEqual(inputs.lengthOf(0), 0);
+		const auto [file, offset] = inputs.locate(0);
+		suite.assertTrue(file == inputs.end());
+		suite.assertEqual(offset, 0);
+	}
+
+	void testOffsets(testsuite &suite)
+	{
+		inputFiles_t inputs{};
+		makeInputs(suite, inputs);
+		suite.assertFalse(inputs.empty());
+		suite.assertEqual(inputs.size(), 3_uz);
+		suite.assertEqual(inputs.totalLength(), 5632);
+		suite.assertEqual(inputs.offsetOf(0), 0);
+		suite.assertEqual(inputs.offsetOf(1), 1024);
+		suite.assertEqual(inputs.offsetOf(2), 5120);
+		suite.assertEqual(inputs.offsetOf(inputs.end()), 5632);
+		suite.assertEqual(inputs.lengthOf(0), 1024);
+		suite.assertEqual(inputs.lengthOf(inputs.begin() + 1), 4096);
+		suite.assertEqual(inputs.lengthOf(2), 512);
+		suite.assertEqual(inputs.lengthOf(inputs.end()), 0);
+		suite.assertEqual(inputs[1].length(), 4096);
+	}
+
+	void testLocate(testsuite &suite)
+	{
+		inputFiles_t inputs{};
+		makeInputs(suite, inputs);
+
+		auto [file, offset] = inputs.locate(0);
+		suite.assertTrue(file == inputs.begin());
+		suite.assertEqual(offset, 0);
+		std::tie(file, offset) = inputs.locate(1023);
+		suite.assertTrue(file == inputs.begin());
+		suite.assertEqual(offset, 1023);
+		// Offsets on the boundary between two inputs belong to the start of the second
+		std::tie(file, offset) = inputs.locate(1024);
+		suite.assertTrue(file == inputs.begin() + 1);
+		suite.assertEqual(offset, 0);
+		std::tie(file, offset) = inputs.locate(5200);
+		suite.assertTrue(file == inputs.begin() + 2);
+		suite.assertEqual(offset, 80);
+		std::tie(file, offset) = inputs.locate(5632);
+		suite.assertTrue(file == inputs.end());
+		suite.assertEqual(offset, 0);
+	}
+
+	void testMetadata(testsuite &suite)
+	{
+		inputFiles_t inputs{};
+		makeInputs(suite, inputs);
+		for (std::size_t index{}; index < inputs.size(); ++index)
+		{
+			const auto metadata{pcat::inputMetadata_t::of(inputs[index])};
+			suite.assertEqual(metadata.length, testFiles[index].second);
+			suite.assertEqual(inputs.lengthOf(index), metadata.length);
+			suite.assertTrue(inputs.deviceOf(index) == metadata.device);
+			suite.assertEqual(inputs.blockSizeOf(index), metadata.blockSize);
+			suite.assertEqual(inputs.alignmentOf(index), metadata.alignment);
+			suite.assertEqual(inputs.sparseAt(index), metadata.sparse);
+#ifndef _WINDOWS
+			suite.assertNotEqual(inputs.blockSizeOf(index), 0_uz);
+#endif
+		}
+		// All the test inputs live in the same directory, so must be on the same device
+		suite.assertTrue(inputs.deviceOf(0) == inputs.deviceOf(1));
+		suite.assertTrue(inputs.deviceOf(1) == inputs.deviceOf(2));
+	}
+
+	void testClear(testsuite &suite)
+	{
+		inputFiles_t inputs{};
+		makeInputs(suite, inputs);
+		inputs.clear();
+		suite.assertTrue(inputs.empty());
+		suite.assertEqual(inputs.totalLength(), 0);
+		makeInputs(suite, inputs);
+		suite.assertEqual(inputs.totalLength(), 5632);
+		suite.assertEqual(inputs.offsetOf(2), 5120);
+	}
+
+	void testLazy(testsuite &suite)
+	{
+		inputFiles_t inputs{};
+		for (const auto &[fileName, length] : testFiles)
+		{
+			fd_t file{fileName.data(), O_RDWR | O_CREAT | O_NOCTTY, normalMode};
+			suite.assertTrue(file.valid());
+			suite.assertTrue(file.resize(length));
+			inputs.emplace_back(fileName, pcat::inputMetadata_t::of(fileName.data()));
+		}
+		inputs.lazy(1);
+		suite.assertTrue(inputs.lazy());
+		suite.assertEqual(inputs.totalLength(), 5632);
+		suite.assertFalse(inputs[0].valid());
+		suite.assertEqual(inputs.openFiles(), 0_uz);
+
+		{
+			// The first input opened takes the only slot in the budget and is kept open
+			const auto first{inputs.acquire(0)};
+			suite.assertTrue(first.valid());
+			suite.assertFalse(first.transient());
+			suite.assertEqual(inputs.openFiles(), 1_uz);
+			// With the budget used, the next is opened only for as long as it's needed
+			const auto second{inputs.acquire(1)};
+			suite.assertTrue(second.valid());
+			suite.assertTrue(second.transient());
+			suite.assertEqual(inputs.openFiles(), 1_uz);
+			inputs.release(1, 4096);
+		}
+		// Copying part of an input must leave it open, while copying the rest closes it
+		inputs.release(0, 512);
+		suite.assertTrue(inputs[0].valid());
+		inputs.release(0, 512);
+		suite.assertFalse(inputs[0].valid());
+		suite.assertEqual(inputs.openFiles(), 0_uz);
+		{
+			const auto third{inputs.acquire(2)};
+			suite.assertTrue(third.valid());
+			suite.assertFalse(third.transient());
+			suite.assertEqual(inputs.openFiles(), 1_uz);
+		}
+		inputs.release(2, 512);
+		suite.assertEqual(inputs.openFiles(), 0_uz);
+
+		for (const auto &[fileName, length] : testFiles)
+			unlink(fileName.data());
+	}
+} // namespace inputFiles
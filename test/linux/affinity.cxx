@@ -1,16 +1,30 @@
 #include <future>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <vector>
 #include <substrate/utility>
 #include <substrate/conversions>
 #include <affinity.hxx>
+#include <processorPlacement.hxx>
 #include <args.hxx>
 #include "testAffinity.hxx"
+#include "fakeTree.hxx"
 
 using namespace std::literals::string_view_literals;
 using pcat::affinity_t;
 using pcat::args::argThreads_t;
 using pcat::args::argPinning_t;
+using pcat::args::argPlacement_t;
+using pcat::args::placement_t;
+using pcat::placeProcessors;
+using pcat::cgroupLimits_t;
+
+constexpr static auto fakeRoot{"cpu.test"sv};
+// More CPUs than fit in a cpu_set_t, as seen on the largest machines
+constexpr static std::size_t wideProcessors{2048U};
+// A machine with 2 packages of 2 cores each, each core having 2 threads, numbered as Linux does
+constexpr static std::size_t fakeProcessors{8U};
 
 namespace affinity
 {
@@ -20,6 +34,8 @@ namespace affinity
 	{
 		suite.assertNotNull(args);
 		suite.assertNull(affinity);
+		// Use every hardware thread, so the affinity covers the whole of the allowed set
+		suite.assertTrue(args->add(substrate::make_unique<argPlacement_t>("threads"sv)));
 		affinity = substrate::make_unique_nothrow<affinity_t>();
 		suite.assertNotNull(affinity);
 	}
@@ -97,6 +113,7 @@ namespace affinity
 		};
 
 		suite.assertNotEqual(processor, UINT32_MAX);
+		args = substrate::make_unique_nothrow<pcat::args::argsTree_t>();
 		suite.assertNotNull(args);
 		suite.assertEqual(args->count(), 0);
 		suite.assertTrue(args->add(substrate::make_unique<argThreads_t>("1"sv)));
@@ -185,4 +202,127 @@ namespace affinity
 		suite.assertTrue(affinity->begin() != affinity->end());
 		suite.assertEqual(*affinity->begin(), processor);
 	}
+
+	// A sysfs CPU tree for a machine with 2 packages of 2 cores each, each core having 2 threads
+	std::vector<fakeTree::entry_t> fakeTopology()
+	{
+		std::vector<fakeTree::entry_t> entries{fakeTree::directory(std::string{fakeRoot})};
+		for (uint32_t cpu{}; cpu < fakeProcessors; ++cpu)
+		{
+			const auto cpuPath{std::string{fakeRoot} + "/cpu" + std::to_string(cpu)};
+			entries.emplace_back(fakeTree::directory(cpuPath));
+			entries.emplace_back(fakeTree::directory(cpuPath + "/topology"));
+			entries.emplace_back(fakeTree::file(cpuPath + "/topology/physical_package_id",
+				std::to_string((cpu / 2U) % 2U) + '\n'));
+			entries.emplace_back(fakeTree::file(cpuPath + "/topology/core_id", std::to_string(cpu % 2U) + '\n'));
+		}
+		return entries;
+	}
+
+	void testPlacement(testsuite &suite)
+	{
+		const std::vector<uint32_t> cpus{0, 1, 2, 3, 4, 5, 6, 7};
+		const fakeTree::fakeTree_t tree{fakeTopology()};
+		suite.assertTrue(tree.valid());
+		const auto threads{placeProcessors(cpus, placement_t::threads, 0, fakeRoot)};
+		const auto cores{placeProcessors(cpus, placement_t::cores, 0, fakeRoot)};
+		const auto coresCapped{placeProcessors(cpus, placement_t::cores, 6, fakeRoot)};
+		const auto compact{placeProcessors(cpus, placement_t::compact, 0, fakeRoot)};
+		const auto scatter{placeProcessors(cpus, placement_t::scatter, 0, fakeRoot)};
+		const auto someCores{placeProcessors({1, 4, 5}, placement_t::cores, 0, fakeRoot)};
+
+		suite.assertTrue(threads == cpus);
+		// One thread per core unless more threads are asked for, in which case siblings follow
+		suite.assertTrue(cores == std::vector<uint32_t>{0, 1, 2, 3});
+		suite.assertTrue(coresCapped == std::vector<uint32_t>{0, 1, 2, 3, 4, 5});
+		suite.assertTrue(compact == std::vector<uint32_t>{0, 4, 1, 5, 2, 6, 3, 7});
+		suite.assertTrue(scatter == std::vector<uint32_t>{0, 2, 1, 3, 4, 6, 5, 7});
+		// A core we may only use the second thread of must still get a worker
+		suite.assertTrue(someCores == std::vector<uint32_t>{1, 4});
+
+		// Without any topology to read, every processor counts as a core of its own
+		suite.assertTrue(placeProcessors(cpus, placement_t::cores, 0, "cpu.missing"sv) == cpus);
+	}
+
+	// Pretends to be a machine with 2048 CPUs, of which we may use 1000-1099 and 2000-2047
+	int wideAffinity(pid_t, const std::size_t size, cpu_set_t *const set) noexcept
+	{
+		// Like the kernel, refuse sets too small to describe every CPU
+		if (size < CPU_ALLOC_SIZE(wideProcessors))
+		{
+			errno = EINVAL;
+			return -1;
+		}
+		CPU_ZERO_S(size, set);
+		for (std::size_t cpu{1000U}; cpu < 1100U; ++cpu)
+			CPU_SET_S(cpu, size, set);
+		for (std::size_t cpu{2000U}; cpu < wideProcessors; ++cpu)
+			CPU_SET_S(cpu, size, set);
+		return 0;
+	}
+
+	void testWideAffinity(testsuite &suite)
+	{
+		args = substrate::make_unique_nothrow<pcat::args::argsTree_t>();
+		suite.assertNotNull(args);
+		suite.assertTrue(args->add(substrate::make_unique<argPlacement_t>("threads"sv)));
+		const affinity_t wideAffinity{"cpu.missing"sv, affinity::wideAffinity};
+		suite.assertEqual(wideAffinity.numProcessors(), 148U);
+		suite.assertEqual(*wideAffinity.begin(), 1000U);
+		suite.assertEqual(*(wideAffinity.end() - 1), 2047U);
+
+		// Slicing with a preference, as done to place workers near their device, must take the preferred first
+		const affinity_t preferred{wideAffinity, 46U, 4U, [](const uint32_t processor) noexcept
+			{ return processor >= 2000U; }};
+		suite.assertEqual(preferred.numProcessors(), 4U);
+		suite.assertEqual(*preferred.begin(), 2046U);
+		suite.assertEqual(*(preferred.begin() + 1), 2047U);
+		suite.assertEqual(*(preferred.begin() + 2), 1000U);
+		suite.assertEqual(*(preferred.begin() + 3), 1001U);
+
+		// Pinning must be able to pick out CPUs past the first 1024 too
+		suite.assertTrue(args->add(substrate::make_unique<argPinning_t>("2040,1050"sv)));
+		const affinity_t pinnedAffinity{"cpu.missing"sv, affinity::wideAffinity};
+		suite.assertEqual(pinnedAffinity.numProcessors(), 2U);
+		suite.assertEqual(*pinnedAffinity.begin(), 1050U);
+		suite.assertEqual(*(pinnedAffinity.begin() + 1), 2040U);
+	}
+
+	void testCgroupLimits(testsuite &suite)
+	{
+		// A job cgroup with a quota of 2.5 CPUs, and a step under it with no quota of its own but a cpuset
+		const fakeTree::fakeTree_t tree
+		{{
+			fakeTree::directory("cgroup.test"), fakeTree::directory("cgroup.test/job"),
+			fakeTree::directory("cgroup.test/job/step"),
+			fakeTree::file("cgroup.test/membership", "1:name=systemd:/job\n0::/job/step\n"sv),
+			fakeTree::file("cgroup.test/job/cpu.max", "250000 100000\n"sv),
+			fakeTree::file("cgroup.test/job/step/cpu.max", "max 100000\n"sv),
+			fakeTree::file("cgroup.test/job/step/cpuset.cpus.effective", "1000-1009\n"sv)
+		}};
+		suite.assertTrue(tree.valid());
+		const cgroupLimits_t limits{"cgroup.test"sv, "cgroup.test/membership"sv};
+
+		suite.assertEqual(limits.cpuQuota(), 3U);
+		suite.assertEqual(limits.cpuset().size(), 10U);
+		const cgroupLimits_t noLimits{"cgroup.missing"sv, "cgroup.missing/membership"sv};
+		suite.assertEqual(noLimits.cpuQuota(), 0U);
+		suite.assertTrue(noLimits.cpuset().empty());
+
+		args = substrate::make_unique_nothrow<pcat::args::argsTree_t>();
+		suite.assertNotNull(args);
+		suite.assertTrue(args->add(substrate::make_unique<argPlacement_t>("threads"sv)));
+		// The cpuset narrows which CPUs are used, and the quota how many of them
+		const affinity_t limited{"cpu.missing"sv, wideAffinity, limits};
+		suite.assertEqual(limited.numProcessors(), 3U);
+		suite.assertEqual(*limited.begin(), 1000U);
+		suite.assertTrue(limited.setSource() == "the cgroup's cpuset"sv);
+		suite.assertTrue(limited.countSource() == "the cgroup's CPU quota"sv);
+
+		// Asking for a number of threads outright overrides the quota
+		suite.assertTrue(args->add(substrate::make_unique<argThreads_t>("6"sv)));
+		const affinity_t requested{"cpu.missing"sv, wideAffinity, limits};
+		suite.assertEqual(requested.numProcessors(), 6U);
+		suite.assertTrue(requested.countSource() == "--threads"sv);
+	}
 } // namespace affinity
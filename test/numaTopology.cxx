@@ -0,0 +1,74 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <substrate/utility>
+#include <numaTopology.hxx>
+#include "testNumaTopology.hxx"
+#include "fakeTree.hxx"
+
+using namespace std::literals::string_view_literals;
+using pcat::parseCPUList;
+using pcat::numaTopology_t;
+
+constexpr static auto fakeRoot{"numa.test"sv};
+// Node 2 is memory-only and node 5 has a gap in numbering before it, as sparse node IDs are valid
+constexpr static auto fakeNodes{substrate::make_array<std::pair<std::string_view, std::string_view>>(
+{
+	{"numa.test/node0"sv, "0-3,8-11\n"sv},
+	{"numa.test/node2"sv, "\n"sv},
+	{"numa.test/node5"sv, "4-7,12-15\n"sv}
+})};
+
+namespace numaTopology
+{
+	void testParseCPUList(testsuite &suite)
+	{
+		suite.assertTrue(parseCPUList("0"sv) == std::vector<uint32_t>{0});
+		suite.assertTrue(parseCPUList("0-3\n"sv) == std::vector<uint32_t>{0, 1, 2, 3});
+		suite.assertTrue(parseCPUList("1,4-5,9"sv) == std::vector<uint32_t>{1, 4, 5, 9});
+		suite.assertTrue(parseCPUList(""sv).empty());
+		suite.assertTrue(parseCPUList("\n"sv).empty());
+		suite.assertTrue(parseCPUList("3-1"sv).empty());
+		suite.assertTrue(parseCPUList("1,,2"sv).empty());
+		suite.assertTrue(parseCPUList("1-"sv).empty());
+		suite.assertTrue(parseCPUList("a"sv).empty());
+	}
+
+	std::vector<fakeTree::entry_t> fakeNodeTree()
+	{
+		std::vector<fakeTree::entry_t> entries{fakeTree::directory(std::string{fakeRoot})};
+		for (const auto &[node, cpulist] : fakeNodes)
+		{
+			entries.emplace_back(fakeTree::directory(std::string{node}));
+			entries.emplace_back(fakeTree::file(std::string{node} + "/cpulist", cpulist));
+		}
+		// Other entries in the node directory must be skipped over
+		entries.emplace_back(fakeTree::file("numa.test/possible"));
+		return entries;
+	}
+
+	void testTopology(testsuite &suite)
+	{
+		const fakeTree::fakeTree_t tree{fakeNodeTree()};
+		suite.assertTrue(tree.valid());
+		const numaTopology_t topology{fakeRoot};
+		// The memory-only node must not count, and the others must be numbered densely
+		suite.assertEqual(topology.nodes(), 2U);
+		for (std::size_t cpu{}; cpu < 16U; ++cpu)
+			suite.assertEqual(topology.nodeOf(cpu), (cpu / 4U) % 2U);
+		// CPUs the topology doesn't know of are treated as being on the first node
+		suite.assertEqual(topology.nodeOf(64U), 0U);
+		suite.assertEqual(topology.indexOf(0U), 0U);
+		suite.assertEqual(topology.indexOf(5U), 1U);
+		suite.assertEqual(topology.indexOf(2U), 2U);
+	}
+
+	void testNoTopology(testsuite &suite)
+	{
+		const numaTopology_t topology{"numa.missing"sv};
+		suite.assertEqual(topology.nodes(), 1U);
+		suite.assertEqual(topology.nodeOf(3U), 0U);
+		suite.assertEqual(topology.currentNode(), 0U);
+		suite.assertEqual(topology.indexOf(0U), 1U);
+	}
+} // namespace numaTopology
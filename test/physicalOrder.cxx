@@ -0,0 +1,94 @@
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <substrate/fd>
+#include <substrate/utility>
+#include <physicalOrder.hxx>
+#include "testPhysicalOrder.hxx"
+
+using namespace std::literals::string_view_literals;
+using substrate::fd_t;
+using substrate::normalMode;
+using substrate::operator ""_KiB;
+using pcat::off_t;
+using pcat::inputFiles;
+using pcat::readExtents;
+using pcat::physicalExtent_t;
+
+pcat::inputFiles_t pcat::inputFiles{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
+
+constexpr static auto dataLength{off_t(64_KiB)};
+constexpr static auto fileLength{dataLength * 3};
+
+namespace physicalOrder
+{
+	// Checks the extents cover exactly the range asked for, one after the other
+	void assertCovers(testsuite &suite, const std::vector<physicalExtent_t> &extents, const off_t offset,
+		const off_t length)
+	{
+		auto position{offset};
+		for (const auto &extent : extents)
+		{
+			suite.assertEqual(extent.offset, position);
+			suite.assertTrue(extent.length > 0);
+			position += extent.length;
+		}
+		suite.assertEqual(position, offset + length);
+	}
+
+	void testReadExtents(testsuite &suite)
+	{
+		constexpr auto fileName{"extents.test"sv};
+		fd_t file{fileName.data(), O_RDWR | O_CREAT | O_TRUNC | O_NOCTTY, normalMode};
+		suite.assertTrue(file.valid());
+		unlink(fileName.data());
+		// Write the input with a hole in the middle, and make sure it's been placed on disk
+		const std::vector<char> data(dataLength, 'x');
+		suite.assertTrue(file.write(data.data(), data.size()));
+		suite.assertEqual(file.seek(dataLength * 2, SEEK_SET), dataLength * 2);
+		suite.assertTrue(file.write(data.data(), data.size()));
+		suite.assertEqual(fsync(file), 0);
+
+		suite.assertTrue(readExtents(fd_t{}, 0, fileLength).empty());
+		const auto extents{readExtents(file, 0, fileLength)};
+		if (extents.empty())
+			suite.skip("The filesystem the test input is on can't say where its data lies");
+		assertCovers(suite, extents, 0, fileLength);
+		assertCovers(suite, readExtents(file, 4096, 8192), 4096, 8192);
+		assertCovers(suite, readExtents(file, dataLength + 4096, 4096), dataLength + 4096, 4096);
+		// The hole must sort straight after the data before it
+		const auto hole{std::find_if(extents.begin(), extents.end(),
+			[](const physicalExtent_t &extent) noexcept { return extent.offset == dataLength; })};
+		suite.assertTrue(hole != extents.begin() && hole != extents.end());
+		const auto &before{*(hole - 1)};
+		suite.assertEqual(hole->physical, before.physical + uint64_t(before.length));
+	}
+
+	void testOrderPlan(testsuite &suite)
+	{
+		inputFiles.clear();
+		// Pairs of which range this was in the plan and where it lies on the device
+		const std::vector<std::pair<std::size_t, uint64_t>> ranges{{0U, 4096U}, {1U, 0U}, {2U, 8192U}, {3U, 0U}};
+		const auto locationOf{[](const std::pair<std::size_t, uint64_t> &range) noexcept
+			{ return std::make_pair(dev_t{}, range.second); }};
+
+		auto plan{ranges};
+		pcat::physicalOrder(plan, locationOf);
+		// The ranges must now be in the order they lie on the device, with the two at the same place kept in order
+		suite.assertEqual(plan[0].first, 1U);
+		suite.assertEqual(plan[1].first, 3U);
+		suite.assertEqual(plan[2].first, 0U);
+		suite.assertEqual(plan[3].first, 2U);
+
+		// In lazy mode the inputs can't be asked about, so the plan must be left alone
+		inputFiles.lazy(1U);
+		plan = ranges;
+		pcat::physicalOrder(plan, locationOf);
+		for (std::size_t index{}; index < plan.size(); ++index)
+			suite.assertEqual(plan[index].first, index);
+		inputFiles.clear();
+	}
+} // namespace physicalOrder
@@ -0,0 +1,85 @@
+#include <string_view>
+#include <vector>
+#include <numeric>
+#include <substrate/fd>
+#include <substrate/utility>
+#include <residency.hxx>
+#include "testResidency.hxx"
+
+using namespace std::literals::string_view_literals;
+using substrate::fd_t;
+using substrate::normalMode;
+using substrate::operator ""_KiB;
+using pcat::off_t;
+using pcat::inputFiles;
+using pcat::residentBytes;
+using pcat::cachedFirst;
+
+pcat::inputFiles_t pcat::inputFiles{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
+
+constexpr static auto inputLength{off_t(256_KiB)};
+constexpr static auto testFiles{substrate::make_array<std::string_view>({"cold.test"sv, "hot.test"sv})};
+
+namespace residency
+{
+	[[nodiscard]] fd_t makeInput(testsuite &suite, const std::string_view fileName)
+	{
+		fd_t file{fileName.data(), O_RDWR | O_CREAT | O_TRUNC | O_NOCTTY, normalMode};
+		suite.assertTrue(file.valid());
+		const std::vector<char> data(inputLength, 'x');
+		suite.assertTrue(file.write(data.data(), data.size()));
+		// Make sure the data is on disk so dropping it from the page cache actually takes
+		suite.assertEqual(fsync(file), 0);
+		unlink(fileName.data());
+		return file;
+	}
+
+	[[nodiscard]] bool evict(const fd_t &file)
+	{
+		posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+		return !residentBytes(file, 0, inputLength);
+	}
+
+	void testResidentBytes(testsuite &suite)
+	{
+		const auto file{makeInput(suite, testFiles[0])};
+		// Having just been written, the input must be entirely in the page cache
+		suite.assertEqual(residentBytes(file, 0, inputLength), inputLength);
+		suite.assertEqual(residentBytes(file, 4096, 8192), 8192);
+		suite.assertEqual(residentBytes(fd_t{}, 0, inputLength), -1);
+		if (!evict(file))
+			suite.skip("The page cache for the test input could not be dropped");
+		suite.assertEqual(residentBytes(file, 0, inputLength), 0);
+	}
+
+	void testCachedFirst(testsuite &suite)
+	{
+		inputFiles.clear();
+		for (const auto &fileName : testFiles)
+			inputFiles.emplace_back(makeInput(suite, fileName));
+		if (!evict(inputFiles[0]))
+		{
+			inputFiles.clear();
+			suite.skip("The page cache for the test input could not be dropped");
+		}
+
+		std::vector<std::size_t> plan(inputFiles.size());
+		std::iota(plan.begin(), plan.end(), 0U);
+		cachedFirst(plan, [](const std::size_t file) noexcept
+			{ return std::make_pair(inputFiles.offsetOf(file), inputFiles.lengthOf(file)); });
+		// The cached input must now come first, with the evicted one after it
+		suite.assertEqual(plan[0], 1U);
+		suite.assertEqual(plan[1], 0U);
+
+		// In lazy mode the inputs can't be asked about, so the plan must be left alone
+		inputFiles.lazy(1U);
+		std::iota(plan.begin(), plan.end(), 0U);
+		cachedFirst(plan, [](const std::size_t file) noexcept
+			{ return std::make_pair(inputFiles.offsetOf(file), inputFiles.lengthOf(file)); });
+		suite.assertEqual(plan[0], 0U);
+		suite.assertEqual(plan[1], 1U);
+		inputFiles.clear();
+	}
+} // namespace residency
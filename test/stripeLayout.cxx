@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <string_view>
+#include <substrate/units>
+#include <stripeLayout.hxx>
+#include "testStripeLayout.hxx"
+
+using substrate::operator ""_KiB;
+using substrate::operator ""_MiB;
+using pcat::off_t;
+using pcat::stripeLayout_t;
+
+constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
+
+namespace stripeLayout
+{
+	// Builds the header of a lustre.lov extended attribute as Lustre would give it for a file
+	std::array<char, 56> lustreLayout(const uint32_t magic, const uint32_t size, const uint16_t count) noexcept
+	{
+		std::array<char, 56> layout{};
+		std::memcpy(layout.data(), &magic, sizeof(magic));
+		std::memcpy(layout.data() + 24, &size, sizeof(size));
+		std::memcpy(layout.data() + 28, &count, sizeof(count));
+		return layout;
+	}
+
+	void testTrim(testsuite &suite)
+	{
+		// With no layout, blocks are left as they are
+		const stripeLayout_t unstriped{};
+		suite.assertFalse(unstriped.enabled());
+		suite.assertEqual(unstriped.trim(off_t(512_KiB), off_t(1_MiB)), off_t(1_MiB));
+
+		const stripeLayout_t layout{off_t(1_MiB), 4U};
+		suite.assertTrue(layout.enabled());
+		// Blocks that stay inside a single stripe are left alone
+		suite.assertEqual(layout.trim(0, off_t(512_KiB)), off_t(512_KiB));
+		suite.assertEqual(layout.trim(off_t(512_KiB), off_t(256_KiB)), off_t(256_KiB));
+		suite.assertEqual(layout.trim(off_t(512_KiB), off_t(512_KiB)), off_t(512_KiB));
+		// Blocks starting on a boundary are cut down to whole stripes
+		suite.assertEqual(layout.trim(0, off_t(4_MiB)), off_t(4_MiB));
+		suite.assertEqual(layout.trim(off_t(1_MiB), off_t(1_MiB) + off_t(512_KiB)), off_t(1_MiB));
+		// Blocks starting part way into a stripe are cut at the end of it
+		suite.assertEqual(layout.trim(off_t(512_KiB), off_t(1_MiB)), off_t(512_KiB));
+		suite.assertEqual(layout.trim(off_t(3_MiB) + 4096, off_t(4_MiB)), off_t(1_MiB) - 4096);
+	}
+
+	void testSpanLength(testsuite &suite)
+	{
+		suite.assertEqual(stripeLayout_t{}.spanLength(12345), off_t(12345));
+		// With only one target there's nothing to spread spans over, so they're just rounded to whole stripes
+		suite.assertEqual(stripeLayout_t{off_t(1_MiB), 1U}.spanLength(off_t(10_MiB) + 4096), off_t(10_MiB));
+
+		const stripeLayout_t layout{off_t(1_MiB), 4U};
+		suite.assertEqual(layout.count(), 4_uz);
+		// 10 stripes would have every other span starting on the same target, and 9 and 11 are as near, so goes up
+		suite.assertEqual(layout.spanLength(off_t(10_MiB)), off_t(11_MiB));
+		suite.assertEqual(layout.spanLength(off_t(9_MiB) + off_t(512_KiB)), off_t(9_MiB));
+		suite.assertEqual(layout.spanLength(off_t(8_MiB)), off_t(9_MiB));
+		// Otherwise the nearest count is taken, whichever way that is
+		const stripeLayout_t sixTargets{off_t(1_MiB), 6U};
+		suite.assertEqual(sixTargets.spanLength(off_t(4_MiB)), off_t(5_MiB));
+		suite.assertEqual(sixTargets.spanLength(off_t(2_MiB)), off_t(1_MiB));
+		// Spans are always at least a stripe long
+		suite.assertEqual(layout.spanLength(off_t(512_KiB)), off_t(1_MiB));
+	}
+
+	void testLustreLayout(testsuite &suite)
+	{
+		const auto v1{lustreLayout(0x0BD10BD0U, uint32_t(4_MiB), 8U)};
+		const auto layout{stripeLayout_t::fromLustre(std::string_view{v1.data(), v1.size()})};
+		suite.assertTrue(layout.enabled());
+		suite.assertEqual(layout.size(), off_t(4_MiB));
+		suite.assertEqual(layout.count(), 8_uz);
+
+		const auto v3{lustreLayout(0x0BD30BD0U, uint32_t(1_MiB), 2U)};
+		const auto layoutV3{stripeLayout_t::fromLustre(std::string_view{v3.data(), v3.size()})};
+		suite.assertEqual(layoutV3.size(), off_t(1_MiB));
+		suite.assertEqual(layoutV3.count(), 2_uz);
+
+		// Composite layouts, short headers and anything else give no layout
+		const auto composite{lustreLayout(0x0BD60BD0U, uint32_t(1_MiB), 2U)};
+		suite.assertFalse(stripeLayout_t::fromLustre(std::string_view{composite.data(), composite.size()}).enabled());
+		suite.assertFalse(stripeLayout_t::fromLustre(std::string_view{v1.data(), 16U}).enabled());
+		suite.assertFalse(stripeLayout_t::fromLustre(std::string_view{}).enabled());
+	}
+} // namespace stripeLayout
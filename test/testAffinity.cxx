@@ -12,6 +12,9 @@ private:
 	void testThreadCap() { affinity::testThreadCap(*this); }
 	void testUserPinning() { affinity::testUserPinning(*this); }
 	void testPinSecondCore() { affinity::testPinSecondCore(*this); }
+	void testPlacement() { affinity::testPlacement(*this); }
+	void testWideAffinity() { affinity::testWideAffinity(*this); }
+	void testCgroupLimits() { affinity::testCgroupLimits(*this); }
 
 public:
 	testAffinity() noexcept { args = substrate::make_unique_nothrow<pcat::args::argsTree_t>(); }
@@ -30,6 +33,9 @@ public:
 		CRUNCHpp_TEST(testThreadCap)
 		CRUNCHpp_TEST(testUserPinning)
 		CRUNCHpp_TEST(testPinSecondCore)
+		CRUNCHpp_TEST(testPlacement)
+		CRUNCHpp_TEST(testWideAffinity)
+		CRUNCHpp_TEST(testCgroupLimits)
 	}
 };
 
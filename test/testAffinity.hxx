@@ -12,6 +12,9 @@ namespace affinity
 	extern void testThreadCap(testsuite &suite);
 	extern void testUserPinning(testsuite &suite);
 	extern void testPinSecondCore(testsuite &suite);
+	extern void testPlacement(testsuite &suite);
+	extern void testWideAffinity(testsuite &suite);
+	extern void testCgroupLimits(testsuite &suite);
 }
 
 #endif /*TEST_AFFINITY__HXX*/
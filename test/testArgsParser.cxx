@@ -14,6 +14,21 @@ private:
 	void testBadPinning() { parser::testBadPinning(*this); }
 	void testChunkSpansAlgorithm() { parser::testChunkSpansAlgorithm(*this); }
 	void testBadAlgorithm() { parser::testBadAlgorithm(*this); }
+	void testGuidedSchedule() { parser::testGuidedSchedule(*this); }
+	void testBadSchedule() { parser::testBadSchedule(*this); }
+	void testDeviceThreads() { parser::testDeviceThreads(*this); }
+	void testBadDeviceThreads() { parser::testBadDeviceThreads(*this); }
+	void testPipelineAlgorithm() { parser::testPipelineAlgorithm(*this); }
+	void testBadStageThreads() { parser::testBadStageThreads(*this); }
+	void testMaxOpen() { parser::testMaxOpen(*this); }
+	void testFilesFrom() { parser::testFilesFrom(*this); }
+	void testRecursive() { parser::testRecursive(*this); }
+	void testEngine() { parser::testEngine(*this); }
+	void testPlacement() { parser::testPlacement(*this); }
+	void testAutoThreads() { parser::testAutoThreads(*this); }
+	void testBlockSize() { parser::testBlockSize(*this); }
+	void testStripes() { parser::testStripes(*this); }
+	void testAutoAlgorithm() { parser::testAutoAlgorithm(*this); }
 
 public:
 	testParser() = default;
@@ -36,6 +51,21 @@ public:
 		CRUNCHpp_TEST(testBadPinning)
 		CRUNCHpp_TEST(testChunkSpansAlgorithm)
 		CRUNCHpp_TEST(testBadAlgorithm)
+		CRUNCHpp_TEST(testGuidedSchedule)
+		CRUNCHpp_TEST(testBadSchedule)
+		CRUNCHpp_TEST(testDeviceThreads)
+		CRUNCHpp_TEST(testBadDeviceThreads)
+		CRUNCHpp_TEST(testPipelineAlgorithm)
+		CRUNCHpp_TEST(testBadStageThreads)
+		CRUNCHpp_TEST(testMaxOpen)
+		CRUNCHpp_TEST(testFilesFrom)
+		CRUNCHpp_TEST(testRecursive)
+		CRUNCHpp_TEST(testEngine)
+		CRUNCHpp_TEST(testPlacement)
+		CRUNCHpp_TEST(testAutoThreads)
+		CRUNCHpp_TEST(testBlockSize)
+		CRUNCHpp_TEST(testStripes)
+		CRUNCHpp_TEST(testAutoAlgorithm)
 	}
 };
 
@@ -16,6 +16,21 @@ namespace parser
 	extern void testBadPinning(testsuite &suite);
 	extern void testChunkSpansAlgorithm(testsuite &suite);
 	extern void testBadAlgorithm(testsuite &suite);
+	extern void testGuidedSchedule(testsuite &suite);
+	extern void testBadSchedule(testsuite &suite);
+	extern void testDeviceThreads(testsuite &suite);
+	extern void testBadDeviceThreads(testsuite &suite);
+	extern void testPipelineAlgorithm(testsuite &suite);
+	extern void testBadStageThreads(testsuite &suite);
+	extern void testMaxOpen(testsuite &suite);
+	extern void testFilesFrom(testsuite &suite);
+	extern void testRecursive(testsuite &suite);
+	extern void testEngine(testsuite &suite);
+	extern void testPlacement(testsuite &suite);
+	extern void testAutoThreads(testsuite &suite);
+	extern void testBlockSize(testsuite &suite);
+	extern void testStripes(testsuite &suite);
+	extern void testAutoAlgorithm(testsuite &suite);
 }
 
 #endif /*TEST_ARGS_PARSER__HXX*/
@@ -0,0 +1,28 @@
+#include "testBlockSize.hxx"
+
+class testBlockSize final : public testsuite
+{
+private:
+	void testFixed() { blockSize::testFixed(*this); }
+	void testAdaptStart() { blockSize::testAdaptStart(*this); }
+	void testAdaptGrow() { blockSize::testAdaptGrow(*this); }
+	void testAdaptShrink() { blockSize::testAdaptShrink(*this); }
+
+public:
+	testBlockSize() noexcept = default;
+	testBlockSize(const testBlockSize &) = delete;
+	testBlockSize(testBlockSize &&) = delete;
+	~testBlockSize() final = default;
+	testBlockSize &operator =(const testBlockSize &) = delete;
+	testBlockSize &operator =(testBlockSize &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testFixed)
+		CRUNCHpp_TEST(testAdaptStart)
+		CRUNCHpp_TEST(testAdaptGrow)
+		CRUNCHpp_TEST(testAdaptShrink)
+	}
+};
+
+CRUNCHpp_TESTS(testBlockSize)
@@ -0,0 +1,14 @@
+#ifndef TEST_BLOCK_SIZE__HXX
+#define TEST_BLOCK_SIZE__HXX
+
+#include <crunch++.h>
+
+namespace blockSize
+{
+	extern void testFixed(testsuite &suite);
+	extern void testAdaptStart(testsuite &suite);
+	extern void testAdaptGrow(testsuite &suite);
+	extern void testAdaptShrink(testsuite &suite);
+}
+
+#endif /*TEST_BLOCK_SIZE__HXX*/
@@ -0,0 +1,28 @@
+#include "testDeviceGroups.hxx"
+
+class testDeviceGroups final : public testsuite
+{
+private:
+	void testGrouping() { deviceGroups::testGrouping(*this); }
+	void testAssignWorkers() { deviceGroups::testAssignWorkers(*this); }
+	void testWorkerLimit() { deviceGroups::testWorkerLimit(*this); }
+	void testDeviceNodes() { deviceGroups::testDeviceNodes(*this); }
+
+public:
+	testDeviceGroups() noexcept = default;
+	testDeviceGroups(const testDeviceGroups &) = delete;
+	testDeviceGroups(testDeviceGroups &&) = delete;
+	~testDeviceGroups() final = default;
+	testDeviceGroups &operator =(const testDeviceGroups &) = delete;
+	testDeviceGroups &operator =(testDeviceGroups &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testGrouping)
+		CRUNCHpp_TEST(testAssignWorkers)
+		CRUNCHpp_TEST(testWorkerLimit)
+		CRUNCHpp_TEST(testDeviceNodes)
+	}
+};
+
+CRUNCHpp_TESTS(testDeviceGroups)
@@ -0,0 +1,14 @@
+#ifndef TEST_DEVICE_GROUPS__HXX
+#define TEST_DEVICE_GROUPS__HXX
+
+#include <crunch++.h>
+
+namespace deviceGroups
+{
+	extern void testGrouping(testsuite &suite);
+	extern void testAssignWorkers(testsuite &suite);
+	extern void testWorkerLimit(testsuite &suite);
+	extern void testDeviceNodes(testsuite &suite);
+}
+
+#endif /*TEST_DEVICE_GROUPS__HXX*/
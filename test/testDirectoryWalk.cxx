@@ -0,0 +1,30 @@
+#include "testDirectoryWalk.hxx"
+
+class testDirectoryWalk final : public testsuite
+{
+private:
+	void testNaturalLess() { directoryWalk::testNaturalLess(*this); }
+	void testLexicalWalk() { directoryWalk::testLexicalWalk(*this); }
+	void testNaturalWalk() { directoryWalk::testNaturalWalk(*this); }
+	void testMissing() { directoryWalk::testMissing(*this); }
+	void testEntryKind() { directoryWalk::testEntryKind(*this); }
+
+public:
+	testDirectoryWalk() noexcept = default;
+	testDirectoryWalk(const testDirectoryWalk &) = delete;
+	testDirectoryWalk(testDirectoryWalk &&) = delete;
+	~testDirectoryWalk() final = default;
+	testDirectoryWalk &operator =(const testDirectoryWalk &) = delete;
+	testDirectoryWalk &operator =(testDirectoryWalk &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testNaturalLess)
+		CRUNCHpp_TEST(testLexicalWalk)
+		CRUNCHpp_TEST(testNaturalWalk)
+		CRUNCHpp_TEST(testMissing)
+		CRUNCHpp_TEST(testEntryKind)
+	}
+};
+
+CRUNCHpp_TESTS(testDirectoryWalk)
@@ -0,0 +1,15 @@
+#ifndef TEST_DIRECTORY_WALK__HXX
+#define TEST_DIRECTORY_WALK__HXX
+
+#include <crunch++.h>
+
+namespace directoryWalk
+{
+	extern void testNaturalLess(testsuite &suite);
+	extern void testLexicalWalk(testsuite &suite);
+	extern void testNaturalWalk(testsuite &suite);
+	extern void testMissing(testsuite &suite);
+	extern void testEntryKind(testsuite &suite);
+}
+
+#endif /*TEST_DIRECTORY_WALK__HXX*/
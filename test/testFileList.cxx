@@ -0,0 +1,30 @@
+#include "testFileList.hxx"
+
+class testFileList final : public testsuite
+{
+private:
+	void testNewlines() { fileList::testNewlines(*this); }
+	void testNULs() { fileList::testNULs(*this); }
+	void testUnterminated() { fileList::testUnterminated(*this); }
+	void testEmpty() { fileList::testEmpty(*this); }
+	void testMissing() { fileList::testMissing(*this); }
+
+public:
+	testFileList() noexcept = default;
+	testFileList(const testFileList &) = delete;
+	testFileList(testFileList &&) = delete;
+	~testFileList() final = default;
+	testFileList &operator =(const testFileList &) = delete;
+	testFileList &operator =(testFileList &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testNewlines)
+		CRUNCHpp_TEST(testNULs)
+		CRUNCHpp_TEST(testUnterminated)
+		CRUNCHpp_TEST(testEmpty)
+		CRUNCHpp_TEST(testMissing)
+	}
+};
+
+CRUNCHpp_TESTS(testFileList)
@@ -0,0 +1,15 @@
+#ifndef TEST_FILE_LIST__HXX
+#define TEST_FILE_LIST__HXX
+
+#include <crunch++.h>
+
+namespace fileList
+{
+	extern void testNewlines(testsuite &suite);
+	extern void testNULs(testsuite &suite);
+	extern void testUnterminated(testsuite &suite);
+	extern void testEmpty(testsuite &suite);
+	extern void testMissing(testsuite &suite);
+}
+
+#endif /*TEST_FILE_LIST__HXX*/
@@ -0,0 +1,32 @@
+#include "testInputFiles.hxx"
+
+class testInputFiles final : public testsuite
+{
+private:
+	void testEmpty() { inputFiles::testEmpty(*this); }
+	void testOffsets() { inputFiles::testOffsets(*this); }
+	void testLocate() { inputFiles::testLocate(*this); }
+	void testClear() { inputFiles::testClear(*this); }
+	void testMetadata() { inputFiles::testMetadata(*this); }
+	void testLazy() { inputFiles::testLazy(*this); }
+
+public:
+	testInputFiles() noexcept = default;
+	testInputFiles(const testInputFiles &) = delete;
+	testInputFiles(testInputFiles &&) = delete;
+	~testInputFiles() final = default;
+	testInputFiles &operator =(const testInputFiles &) = delete;
+	testInputFiles &operator =(testInputFiles &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testEmpty)
+		CRUNCHpp_TEST(testOffsets)
+		CRUNCHpp_TEST(testLocate)
+		CRUNCHpp_TEST(testClear)
+		CRUNCHpp_TEST(testMetadata)
+		CRUNCHpp_TEST(testLazy)
+	}
+};
+
+CRUNCHpp_TESTS(testInputFiles)
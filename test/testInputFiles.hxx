@@ -0,0 +1,16 @@
+#ifndef TEST_INPUT_FILES__HXX
+#define TEST_INPUT_FILES__HXX
+
+#include <crunch++.h>
+
+namespace inputFiles
+{
+	extern void testEmpty(testsuite &suite);
+	extern void testOffsets(testsuite &suite);
+	extern void testLocate(testsuite &suite);
+	extern void testClear(testsuite &suite);
+	extern void testMetadata(testsuite &suite);
+	extern void testLazy(testsuite &suite);
+}
+
+#endif /*TEST_INPUT_FILES__HXX*/
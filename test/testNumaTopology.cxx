@@ -0,0 +1,26 @@
+#include "testNumaTopology.hxx"
+
+class testNumaTopology final : public testsuite
+{
+private:
+	void testParseCPUList() { numaTopology::testParseCPUList(*this); }
+	void testTopology() { numaTopology::testTopology(*this); }
+	void testNoTopology() { numaTopology::testNoTopology(*this); }
+
+public:
+	testNumaTopology() noexcept = default;
+	testNumaTopology(const testNumaTopology &) = delete;
+	testNumaTopology(testNumaTopology &&) = delete;
+	~testNumaTopology() final = default;
+	testNumaTopology &operator =(const testNumaTopology &) = delete;
+	testNumaTopology &operator =(testNumaTopology &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testParseCPUList)
+		CRUNCHpp_TEST(testTopology)
+		CRUNCHpp_TEST(testNoTopology)
+	}
+};
+
+CRUNCHpp_TESTS(testNumaTopology)
@@ -0,0 +1,13 @@
+#ifndef TEST_NUMA_TOPOLOGY__HXX
+#define TEST_NUMA_TOPOLOGY__HXX
+
+#include <crunch++.h>
+
+namespace numaTopology
+{
+	extern void testParseCPUList(testsuite &suite);
+	extern void testTopology(testsuite &suite);
+	extern void testNoTopology(testsuite &suite);
+}
+
+#endif /*TEST_NUMA_TOPOLOGY__HXX*/
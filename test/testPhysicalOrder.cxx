@@ -0,0 +1,24 @@
+#include "testPhysicalOrder.hxx"
+
+class testPhysicalOrder final : public testsuite
+{
+private:
+	void testReadExtents() { physicalOrder::testReadExtents(*this); }
+	void testOrderPlan() { physicalOrder::testOrderPlan(*this); }
+
+public:
+	testPhysicalOrder() noexcept = default;
+	testPhysicalOrder(const testPhysicalOrder &) = delete;
+	testPhysicalOrder(testPhysicalOrder &&) = delete;
+	~testPhysicalOrder() final = default;
+	testPhysicalOrder &operator =(const testPhysicalOrder &) = delete;
+	testPhysicalOrder &operator =(testPhysicalOrder &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testReadExtents)
+		CRUNCHpp_TEST(testOrderPlan)
+	}
+};
+
+CRUNCHpp_TESTS(testPhysicalOrder)
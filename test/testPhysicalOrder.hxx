@@ -0,0 +1,12 @@
+#ifndef TEST_PHYSICAL_ORDER__HXX
+#define TEST_PHYSICAL_ORDER__HXX
+
+#include <crunch++.h>
+
+namespace physicalOrder
+{
+	extern void testReadExtents(testsuite &suite);
+	extern void testOrderPlan(testsuite &suite);
+}
+
+#endif /*TEST_PHYSICAL_ORDER__HXX*/
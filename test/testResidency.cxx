@@ -0,0 +1,24 @@
+#include "testResidency.hxx"
+
+class testResidency final : public testsuite
+{
+private:
+	void testResidentBytes() { residency::testResidentBytes(*this); }
+	void testCachedFirst() { residency::testCachedFirst(*this); }
+
+public:
+	testResidency() noexcept = default;
+	testResidency(const testResidency &) = delete;
+	testResidency(testResidency &&) = delete;
+	~testResidency() final = default;
+	testResidency &operator =(const testResidency &) = delete;
+	testResidency &operator =(testResidency &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testResidentBytes)
+		CRUNCHpp_TEST(testCachedFirst)
+	}
+};
+
+CRUNCHpp_TESTS(testResidency)
@@ -0,0 +1,12 @@
+#ifndef TEST_RESIDENCY__HXX
+#define TEST_RESIDENCY__HXX
+
+#include <crunch++.h>
+
+namespace residency
+{
+	extern void testResidentBytes(testsuite &suite);
+	extern void testCachedFirst(testsuite &suite);
+}
+
+#endif /*TEST_RESIDENCY__HXX*/
@@ -0,0 +1,26 @@
+#include "testStripeLayout.hxx"
+
+class testStripeLayout final : public testsuite
+{
+private:
+	void testTrim() { stripeLayout::testTrim(*this); }
+	void testSpanLength() { stripeLayout::testSpanLength(*this); }
+	void testLustreLayout() { stripeLayout::testLustreLayout(*this); }
+
+public:
+	testStripeLayout() noexcept = default;
+	testStripeLayout(const testStripeLayout &) = delete;
+	testStripeLayout(testStripeLayout &&) = delete;
+	~testStripeLayout() final = default;
+	testStripeLayout &operator =(const testStripeLayout &) = delete;
+	testStripeLayout &operator =(testStripeLayout &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testTrim)
+		CRUNCHpp_TEST(testSpanLength)
+		CRUNCHpp_TEST(testLustreLayout)
+	}
+};
+
+CRUNCHpp_TESTS(testStripeLayout)
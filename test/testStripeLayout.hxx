@@ -0,0 +1,13 @@
+#ifndef TEST_STRIPE_LAYOUT__HXX
+#define TEST_STRIPE_LAYOUT__HXX
+
+#include <crunch++.h>
+
+namespace stripeLayout
+{
+	extern void testTrim(testsuite &suite);
+	extern void testSpanLength(testsuite &suite);
+	extern void testLustreLayout(testsuite &suite);
+}
+
+#endif /*TEST_STRIPE_LAYOUT__HXX*/
@@ -8,6 +8,10 @@ private:
 	void testUnused() { threadPool::testUnused(*this); }
 	void testOnce() { threadPool::testOnce(*this); }
 	void testQueueWait() { threadPool::testQueueWait(*this); }
+	void testLazyWorkers() { threadPool::testLazyWorkers(*this); }
+	void testStartupLatency() { threadPool::testStartupLatency(*this); }
+	void testThroughputController() { threadPool::testThroughputController(*this); }
+	void testControlledPool() { threadPool::testControlledPool(*this); }
 
 public:
 	testThreadPool() { args = substrate::make_unique<pcat::args::argsTree_t>(); }
@@ -23,6 +27,10 @@ public:
 		CRUNCHpp_TEST(testUnused)
 		CRUNCHpp_TEST(testOnce)
 		CRUNCHpp_TEST(testQueueWait)
+		CRUNCHpp_TEST(testLazyWorkers)
+		CRUNCHpp_TEST(testStartupLatency)
+		CRUNCHpp_TEST(testThroughputController)
+		CRUNCHpp_TEST(testControlledPool)
 	}
 };
 
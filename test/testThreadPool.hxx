@@ -8,6 +8,10 @@ namespace threadPool
 	extern void testUnused(testsuite &suite);
 	extern void testOnce(testsuite &suite);
 	extern void testQueueWait(testsuite &suite);
+	extern void testLazyWorkers(testsuite &suite);
+	extern void testStartupLatency(testsuite &suite);
+	extern void testThroughputController(testsuite &suite);
+	extern void testControlledPool(testsuite &suite);
 }
 
 #endif /*TEST_THREAD_POOL__HXX*/
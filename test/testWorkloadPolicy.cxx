@@ -0,0 +1,26 @@
+#include "testWorkloadPolicy.hxx"
+
+class testWorkloadPolicy final : public testsuite
+{
+private:
+	void testFilesystemKinds() { workloadPolicy::testFilesystemKinds(*this); }
+	void testProfileWorkload() { workloadPolicy::testProfileWorkload(*this); }
+	void testChoosePolicy() { workloadPolicy::testChoosePolicy(*this); }
+
+public:
+	testWorkloadPolicy() noexcept = default;
+	testWorkloadPolicy(const testWorkloadPolicy &) = delete;
+	testWorkloadPolicy(testWorkloadPolicy &&) = delete;
+	~testWorkloadPolicy() final = default;
+	testWorkloadPolicy &operator =(const testWorkloadPolicy &) = delete;
+	testWorkloadPolicy &operator =(testWorkloadPolicy &&) = delete;
+
+	void registerTests() final
+	{
+		CRUNCHpp_TEST(testFilesystemKinds)
+		CRUNCHpp_TEST(testProfileWorkload)
+		CRUNCHpp_TEST(testChoosePolicy)
+	}
+};
+
+CRUNCHpp_TESTS(testWorkloadPolicy)
@@ -0,0 +1,13 @@
+#ifndef TEST_WORKLOAD_POLICY__HXX
+#define TEST_WORKLOAD_POLICY__HXX
+
+#include <crunch++.h>
+
+namespace workloadPolicy
+{
+	extern void testFilesystemKinds(testsuite &suite);
+	extern void testProfileWorkload(testsuite &suite);
+	extern void testChoosePolicy(testsuite &suite);
+}
+
+#endif /*TEST_WORKLOAD_POLICY__HXX*/
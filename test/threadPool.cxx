@@ -2,12 +2,15 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <atomic>
+#include <algorithm>
 #include <substrate/utility>
 #include <threadPool.hxx>
 #include "testThreadPool.hxx"
 
 using pcat::affinity_t;
 using pcat::threadPool_t;
+using pcat::throughputController_t;
 using namespace std::literals::chrono_literals;
 
 constexpr static std::size_t operator ""_uz(const unsigned long long value) noexcept { return value; }
@@ -15,6 +18,8 @@ constexpr static auto totalLoopIterations = 1000000_uz;
 
 std::mutex workMutex;
 std::condition_variable workCond;
+std::atomic<std::size_t> runningWorkers{};
+std::atomic<std::size_t> peakWorkers{};
 
 namespace threadPool
 {
@@ -90,4 +95,122 @@ namespace threadPool
 		puts("already finished");
 		suite.assertFalse(pool.finish());
 	}
+
+	void testLazyWorkers(testsuite &suite)
+	{
+		threadPool_t pool{dummyWork};
+		suite.assertTrue(pool.valid());
+		suite.assertTrue(pool.ready());
+		suite.assertEqual(pool.numWorkers(), 0);
+		suite.assertFalse(pool.queue());
+		suite.assertEqual(pool.numWorkers(), 1);
+		suite.assertTrue(pool.finish());
+		suite.assertEqual(pool.numWorkers(), 0);
+		suite.assertFalse(pool.valid());
+	}
+
+	void testStartupLatency(testsuite &suite)
+	{
+		using clock_t = std::chrono::steady_clock;
+		const auto processors{affinity_t{}.numProcessors()};
+		// Take the quickest of a few bring-ups of each so a badly timed reschedule can't skew the comparison
+		constexpr std::size_t attempts{5U};
+		auto lazyTime{clock_t::duration::max()};
+		auto eagerTime{clock_t::duration::max()};
+
+		for (std::size_t attempt{}; attempt < attempts; ++attempt)
+		{
+			const auto lazyBegin{clock_t::now()};
+			auto lazyPool{substrate::make_unique_nothrow<threadPool_t<decltype(dummyWork)>>(dummyWork)};
+			lazyTime = std::min(lazyTime, clock_t::now() - lazyBegin);
+			suite.assertNotNull(lazyPool);
+			suite.assertTrue(lazyPool->ready());
+			suite.assertEqual(lazyPool->numWorkers(), 0);
+
+			const auto eagerBegin{clock_t::now()};
+			auto eagerPool{substrate::make_unique_nothrow<threadPool_t<decltype(dummyWork)>>(dummyWork, processors)};
+			eagerTime = std::min(eagerTime, clock_t::now() - eagerBegin);
+			suite.assertNotNull(eagerPool);
+			suite.assertTrue(eagerPool->ready());
+			suite.assertEqual(eagerPool->numWorkers(), processors);
+
+			suite.assertFalse(eagerPool->finish());
+			suite.assertFalse(lazyPool->finish());
+		}
+		// Bringing up a pool lazily starts no threads, so must be no slower than starting them all up front
+		suite.assertTrue(lazyTime <= eagerTime);
+	}
+
+	bool pacedWork()
+	{
+		const auto running{++runningWorkers};
+		auto peak{peakWorkers.load()};
+		while (running > peak && !peakWorkers.compare_exchange_weak(peak, running))
+			continue;
+		for (std::size_t block{}; block < 4U; ++block)
+		{
+			std::this_thread::sleep_for(100us);
+			pcat::throughput::transferred(4096U);
+			--runningWorkers;
+			pcat::throughput::pace();
+			++runningWorkers;
+		}
+		--runningWorkers;
+		return true;
+	}
+
+	// Throughput that scales with the worker count up to 4 workers, then falls off as they contend
+	double syntheticRate(const std::size_t workers) noexcept
+	{
+		// NOLINTNEXTLINE(readability-magic-numbers)
+		return workers <= 4U ? double(workers) * 100.0 : 400.0 - (double(workers - 4U) * 50.0);
+	}
+
+	void testThroughputController(testsuite &suite)
+	{
+		throughputController_t controller{8U};
+		suite.assertEqual(controller.maximum(), 8U);
+		suite.assertEqual(controller.active(), throughputController_t::initialWorkers);
+		// The first window is a baseline, then each extra worker pays for itself up to 4
+		suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 3U);
+		suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 4U);
+		suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 5U);
+		// A 5th worker costs throughput, so the controller steps back and settles on 4
+		suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 4U);
+		for (std::size_t window{}; window < throughputController_t::probeWindows; ++window)
+			suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 4U);
+		// Having sat settled for a while, it probes with one worker fewer, finds that worse, and steps back again
+		suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 3U);
+		suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 4U);
+		suite.assertEqual(controller.adjust(syntheticRate(controller.active())), 4U);
+
+		// If the throughput changes under it, it goes looking again, stepping back when another worker does not help
+		suite.assertEqual(controller.adjust(syntheticRate(3U)), 5U);
+		suite.assertEqual(controller.adjust(syntheticRate(3U)), 4U);
+		suite.assertEqual(controller.adjust(syntheticRate(3U)), 4U);
+
+		// The count never goes past the maximum the pool has workers for
+		throughputController_t smallController{3U};
+		suite.assertEqual(smallController.adjust(syntheticRate(smallController.active())), 3U);
+		suite.assertEqual(smallController.adjust(syntheticRate(smallController.active())), 3U);
+		suite.assertEqual(smallController.active(), 3U);
+	}
+
+	void testControlledPool(testsuite &suite)
+	{
+		const auto processors{affinity_t{}.numProcessors()};
+		threadPool_t pool{pacedWork, processors};
+		suite.assertEqual(pool.activeWorkers(), processors);
+		pool.controlThroughput();
+		suite.assertEqual(pool.activeWorkers(), std::min(throughputController_t::initialWorkers, processors));
+		runningWorkers = 0U;
+		peakWorkers = 0U;
+		for (std::size_t item{}; item < processors * 4U; ++item)
+			[[maybe_unused]] const auto result = pool.queue();
+		// Every item must get run, parked workers included, before finish() returns
+		suite.assertTrue(pool.finish());
+		suite.assertEqual(runningWorkers.load(), 0U);
+		suite.assertTrue(peakWorkers <= processors);
+		suite.assertTrue(peakWorkers >= 1U);
+	}
 } // namespace threadPool
@@ -2,8 +2,8 @@
 #include <chrono>
 #include <future>
 #include <threadedQueue.hxx>
+#include <latch.hxx>
 #include "testThreadedQueue.hxx"
-#include "latch.hxx"
 
 using namespace std::literals::chrono_literals;
 using pcat::threadedQueue_t;
@@ -228,4 +228,13 @@ namespace affinity
 		suite.assertEqual(affinity->begin()->first, processor.first);
 		suite.assertEqual(affinity->begin()->second, processor.second);
 	}
+
+	void testPlacement(testsuite &suite)
+		{ suite.skip("Processor placement by topology is only done on Linux"); }
+
+	void testWideAffinity(testsuite &suite)
+		{ suite.skip("Processor groups already cover more than 1024 processors on Windows"); }
+
+	void testCgroupLimits(testsuite &suite)
+		{ suite.skip("cgroups are only found on Linux"); }
 } // namespace affinity
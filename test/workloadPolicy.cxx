@@ -0,0 +1,166 @@
+#include <string_view>
+#include <vector>
+#include <substrate/fd>
+#include <substrate/utility>
+#include <workloadPolicy.hxx>
+#include "testWorkloadPolicy.hxx"
+
+using namespace std::literals::string_view_literals;
+using substrate::fd_t;
+using substrate::normalMode;
+using substrate::operator ""_KiB;
+using substrate::operator ""_MiB;
+using substrate::operator ""_GiB;
+using pcat::off_t;
+using pcat::inputFiles;
+using pcat::filesystem_t;
+using pcat::workloadProfile_t;
+using pcat::workloadPolicy_t;
+using pcat::args::algorithm_t;
+using pcat::args::schedule_t;
+using pcat::args::engine_t;
+namespace filesystem = pcat::filesystem;
+
+pcat::inputFiles_t pcat::inputFiles{};
+pcat::blockSize_t pcat::blockSize{};
+pcat::stripeLayout_t pcat::stripeLayout{};
+
+namespace workloadPolicy
+{
+	// A profile of a copy of a few large inputs between the given filesystems
+	workloadProfile_t largeCopy(const filesystem_t inputs, const filesystem_t output, const bool sharedDevice)
+	{
+		workloadProfile_t profile{};
+		profile.files = 4U;
+		profile.totalLength = off_t(4_GiB);
+		profile.medianLength = off_t(1_GiB);
+		profile.largestLength = off_t(1_GiB);
+		profile.processors = 8U;
+		profile.inputs = inputs;
+		profile.output = output;
+		profile.sharedDevice = sharedDevice;
+		return profile;
+	}
+
+	void assertPolicy(testsuite &suite, const workloadPolicy_t &policy, const algorithm_t algorithm,
+		const engine_t engine, const bool tuneBlockSize, const bool tuneThreads)
+	{
+		suite.assertEqual(static_cast<uint8_t>(policy.algorithm), static_cast<uint8_t>(algorithm));
+		suite.assertEqual(static_cast<uint8_t>(policy.engine), static_cast<uint8_t>(engine));
+		suite.assertEqual(policy.tuneBlockSize, tuneBlockSize);
+		suite.assertEqual(policy.tuneThreads, tuneThreads);
+		// Every choice made must come with a reason
+		suite.assertFalse(policy.reasons.empty());
+	}
+
+	void testFilesystemKinds(testsuite &suite)
+	{
+		suite.assertTrue(filesystem::fromMagic(0x0BD00BD0U) == filesystem_t::lustre);
+		suite.assertTrue(filesystem::fromMagic(0x47504653U) == filesystem_t::gpfs);
+		suite.assertTrue(filesystem::fromMagic(0x6969U) == filesystem_t::nfs);
+		suite.assertTrue(filesystem::fromMagic(0x01021994U) == filesystem_t::tmpfs);
+		suite.assertTrue(filesystem::fromMagic(0x58465342U) == filesystem_t::xfs);
+		suite.assertTrue(filesystem::fromMagic(0xEF53U) == filesystem_t::ext4);
+		suite.assertTrue(filesystem::fromMagic(0x9123683EU) == filesystem_t::other);
+		suite.assertTrue(filesystem::parallel(filesystem_t::lustre));
+		suite.assertTrue(filesystem::parallel(filesystem_t::gpfs));
+		suite.assertFalse(filesystem::parallel(filesystem_t::nfs));
+		suite.assertEqual(filesystem::nameOf(filesystem_t::lustre), "Lustre"sv);
+		suite.assertTrue(filesystem::of(fd_t{}) == filesystem_t::other);
+	}
+
+	void testProfileWorkload(testsuite &suite)
+	{
+		inputFiles.clear();
+		const std::vector<char> data(64_KiB, 'x');
+		for (const auto length : {off_t(4_KiB), off_t(64_KiB), off_t(8_KiB)})
+		{
+			constexpr auto fileName{"profile.test"sv};
+			fd_t file{fileName.data(), O_RDWR | O_CREAT | O_TRUNC | O_NOCTTY, normalMode};
+			suite.assertTrue(file.valid());
+			unlink(fileName.data());
+			suite.assertTrue(file.write(data.data(), std::size_t(length)));
+			inputFiles.emplace_back(std::move(file));
+		}
+		constexpr auto outputName{"profileOutput.test"sv};
+		fd_t output{outputName.data(), O_RDWR | O_CREAT | O_TRUNC | O_NOCTTY, normalMode};
+		suite.assertTrue(output.valid());
+		unlink(outputName.data());
+
+		auto profile{pcat::profileWorkload(output, 2U)};
+		suite.assertEqual(profile.files, 3U);
+		suite.assertEqual(profile.totalLength, off_t(76_KiB));
+		suite.assertEqual(profile.medianLength, off_t(8_KiB));
+		suite.assertEqual(profile.largestLength, off_t(64_KiB));
+		suite.assertEqual(profile.processors, 2U);
+		// The inputs were made alongside the output, so must be on the same device and filesystem
+		suite.assertTrue(profile.sharedDevice);
+		suite.assertTrue(profile.inputs == profile.output);
+		suite.assertTrue(profile.cachedInputs + profile.coldInputs <= 3U);
+
+		// In lazy mode the inputs can't be asked about the page cache
+		inputFiles.lazy(1U);
+		profile = pcat::profileWorkload(output, 0U);
+		suite.assertEqual(profile.processors, 1U);
+		suite.assertEqual(profile.cachedInputs + profile.coldInputs, 0U);
+		inputFiles.clear();
+
+		profile = pcat::profileWorkload(output, 2U);
+		suite.assertEqual(profile.files, 0U);
+		suite.assertEqual(profile.totalLength, 0);
+		suite.assertFalse(profile.sharedDevice);
+	}
+
+	void testChoosePolicy(testsuite &suite)
+	{
+		// Copies entirely in memory are left at the defaults
+		auto policy{pcat::choosePolicy(largeCopy(filesystem_t::tmpfs, filesystem_t::tmpfs, true))};
+		assertPolicy(suite, policy, algorithm_t::blockLinear, engine_t::mmap, false, false);
+
+		// Parallel filesystems get guided spans lined up with the stripes
+		policy = pcat::choosePolicy(largeCopy(filesystem_t::lustre, filesystem_t::lustre, true));
+		assertPolicy(suite, policy, algorithm_t::chunkSpans, engine_t::mmap, true, false);
+		suite.assertTrue(policy.schedule == schedule_t::guidedSpans);
+		suite.assertTrue(policy.alignStripes);
+		policy = pcat::choosePolicy(largeCopy(filesystem_t::ext4, filesystem_t::gpfs, false));
+		suite.assertTrue(policy.algorithm == algorithm_t::chunkSpans);
+
+		// Unless the output is too short to give each thread a span, or the inputs are mostly small
+		auto profile{largeCopy(filesystem_t::lustre, filesystem_t::lustre, true)};
+		profile.totalLength = off_t(8_MiB);
+		policy = pcat::choosePolicy(profile);
+		assertPolicy(suite, policy, algorithm_t::blockLinear, engine_t::mmap, false, false);
+		suite.assertFalse(policy.alignStripes);
+		profile = largeCopy(filesystem_t::lustre, filesystem_t::lustre, true);
+		profile.files = 100000U;
+		profile.medianLength = off_t(4_KiB);
+		policy = pcat::choosePolicy(profile);
+		assertPolicy(suite, policy, algorithm_t::blockLinear, engine_t::mmap, false, false);
+
+		// Inputs on different devices to the output are pipelined, with threads tuned when over the network
+		policy = pcat::choosePolicy(largeCopy(filesystem_t::xfs, filesystem_t::ext4, false));
+		assertPolicy(suite, policy, algorithm_t::pipeline, engine_t::mmap, true, false);
+		// Even when those devices have the same filesystem on them
+		policy = pcat::choosePolicy(largeCopy(filesystem_t::ext4, filesystem_t::ext4, false));
+		assertPolicy(suite, policy, algorithm_t::pipeline, engine_t::mmap, true, false);
+		policy = pcat::choosePolicy(largeCopy(filesystem_t::nfs, filesystem_t::xfs, false));
+		assertPolicy(suite, policy, algorithm_t::pipeline, engine_t::mmap, true, true);
+		// But not from or to memory, where there's no latency to hide
+		policy = pcat::choosePolicy(largeCopy(filesystem_t::xfs, filesystem_t::tmpfs, false));
+		assertPolicy(suite, policy, algorithm_t::blockLinear, engine_t::mmap, false, false);
+
+		// Inputs sharing the output's device contend with it, and mixed cache residency wants nowait
+		profile = largeCopy(filesystem_t::ext4, filesystem_t::ext4, true);
+		profile.cachedInputs = 1U;
+		profile.coldInputs = 3U;
+		policy = pcat::choosePolicy(profile);
+		assertPolicy(suite, policy, algorithm_t::blockLinear, engine_t::nowait, true, true);
+		suite.assertEqual(policy.reasons.size(), 4U);
+		// The pipeline reads for itself, so takes no engine
+		profile = largeCopy(filesystem_t::xfs, filesystem_t::ext4, false);
+		profile.cachedInputs = 1U;
+		profile.coldInputs = 3U;
+		policy = pcat::choosePolicy(profile);
+		assertPolicy(suite, policy, algorithm_t::pipeline, engine_t::mmap, true, false);
+	}
+} // namespace workloadPolicy